@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_ITERATIONS 200
+#define N_ROWS 100
+
+
+static GtkWidget *
+create_title_row (void)
+{
+  GtkWidget *row = hdy_action_row_new ();
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Title");
+
+  return row;
+}
+
+
+static GtkWidget *
+create_full_row (void)
+{
+  GtkWidget *row = hdy_action_row_new ();
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Title");
+  hdy_action_row_set_subtitle (HDY_ACTION_ROW (row), "Subtitle");
+  hdy_action_row_set_icon_name (HDY_ACTION_ROW (row), "emblem-system-symbolic");
+  hdy_action_row_add_prefix (HDY_ACTION_ROW (row), gtk_check_button_new ());
+  gtk_container_add (GTK_CONTAINER (row), gtk_switch_new ());
+
+  return row;
+}
+
+
+static void
+create_list (gpointer user_data)
+{
+  GtkWidget *(*create_row) (void) = user_data;
+  GtkWidget *list = gtk_list_box_new ();
+  guint i;
+
+  g_object_ref_sink (list);
+
+  for (i = 0; i < N_ROWS; i++)
+    gtk_container_add (GTK_CONTAINER (list), create_row ());
+
+  gtk_widget_show_all (list);
+
+  gtk_widget_destroy (list);
+  g_object_unref (list);
+}
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  /* Rows with only a title don't create their optional children, while rows
+   * using every part of the row create all of them. The difference in the
+   * number of allocations per list shows what the rows save when the optional
+   * children are left out.
+   */
+  bench_measure ("list of title rows", N_ITERATIONS, create_list, create_title_row);
+  bench_measure ("list of full rows", N_ITERATIONS, create_list, create_full_row);
+
+  return 0;
+}
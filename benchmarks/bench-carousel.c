@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_PAGES 5
+#define N_ITERATIONS 10
+#define WIDTH 360
+#define HEIGHT 640
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  g_autoptr (BenchStats) stats = NULL;
+  GtkWidget *carousel, *window;
+  GtkWidget *pages[N_PAGES];
+  guint duration;
+  gint i, j;
+
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  carousel = hdy_carousel_new ();
+  for (i = 0; i < N_PAGES; i++) {
+    g_autofree gchar *label = g_strdup_printf ("Page %d", i);
+
+    pages[i] = gtk_label_new (label);
+    gtk_widget_set_hexpand (pages[i], TRUE);
+    gtk_widget_show (pages[i]);
+    hdy_carousel_insert (HDY_CAROUSEL (carousel), pages[i], -1);
+  }
+  gtk_widget_show (carousel);
+
+  duration = hdy_carousel_get_animation_duration (HDY_CAROUSEL (carousel));
+
+  stats = bench_stats_new ("carousel swipes");
+  window = bench_window_new (carousel, stats, WIDTH, HEIGHT);
+  bench_run_for (duration);
+  bench_stats_reset (stats);
+
+  for (i = 0; i < N_ITERATIONS; i++) {
+    for (j = 1; j < N_PAGES; j++) {
+      hdy_carousel_scroll_to (HDY_CAROUSEL (carousel), pages[j]);
+      bench_run_for (duration * 2);
+    }
+
+    for (j = N_PAGES - 2; j >= 0; j--) {
+      hdy_carousel_scroll_to (HDY_CAROUSEL (carousel), pages[j]);
+      bench_run_for (duration * 2);
+    }
+  }
+
+  bench_stats_print (stats);
+
+  gtk_widget_destroy (window);
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_CHILDREN 5
+#define N_ITERATIONS 10
+#define WIDTH 360
+#define HEIGHT 640
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  g_autoptr (BenchStats) stats = NULL;
+  GtkWidget *deck, *window;
+  guint duration;
+  gint i, j;
+
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  deck = hdy_deck_new ();
+  for (i = 0; i < N_CHILDREN; i++) {
+    g_autofree gchar *label = g_strdup_printf ("Page %d", i);
+    GtkWidget *child = gtk_label_new (label);
+
+    gtk_widget_show (child);
+    gtk_container_add (GTK_CONTAINER (deck), child);
+  }
+  gtk_widget_show (deck);
+
+  duration = hdy_deck_get_transition_duration (HDY_DECK (deck));
+
+  stats = bench_stats_new ("deck navigation");
+  window = bench_window_new (deck, stats, WIDTH, HEIGHT);
+  bench_run_for (duration);
+  bench_stats_reset (stats);
+
+  for (i = 0; i < N_ITERATIONS; i++) {
+    for (j = 1; j < N_CHILDREN; j++) {
+      hdy_deck_navigate (HDY_DECK (deck), HDY_NAVIGATION_DIRECTION_FORWARD);
+      bench_run_for (duration * 2);
+    }
+
+    for (j = 1; j < N_CHILDREN; j++) {
+      hdy_deck_navigate (HDY_DECK (deck), HDY_NAVIGATION_DIRECTION_BACK);
+      bench_run_for (duration * 2);
+    }
+  }
+
+  bench_stats_print (stats);
+
+  gtk_widget_destroy (window);
+
+  return 0;
+}
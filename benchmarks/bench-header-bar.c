@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_ITERATIONS 5
+#define N_PAGES 4
+#define MIN_WIDTH 360
+#define MAX_WIDTH 1200
+#define WIDTH_STEP 10
+#define HEIGHT 200
+
+static const gchar * const page_icons[] = {
+  "go-home-symbolic",
+  "document-open-recent-symbolic",
+  "starred-symbolic",
+  "emblem-system-symbolic",
+};
+
+
+/* The header bar, the squeezer and the view switchers all apply their CSS box
+ * model with hdy_css_measure() and hdy_css_size_allocate(), so resizing this
+ * exercises them on every frame.
+ */
+static GtkWidget *
+create_content (void)
+{
+  GtkWidget *box, *header_bar, *squeezer, *stack, *switcher;
+  gint i;
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  header_bar = hdy_header_bar_new ();
+  squeezer = hdy_squeezer_new ();
+  stack = gtk_stack_new ();
+
+  for (i = 0; i < N_PAGES; i++) {
+    g_autofree gchar *name = g_strdup_printf ("page%d", i);
+    g_autofree gchar *title = g_strdup_printf ("Page %d", i);
+    GtkWidget *page = gtk_label_new (title);
+
+    gtk_container_add (GTK_CONTAINER (stack), page);
+    gtk_container_child_set (GTK_CONTAINER (stack), page,
+                             "name", name,
+                             "title", title,
+                             "icon-name", page_icons[i],
+                             NULL);
+  }
+
+  switcher = hdy_view_switcher_new ();
+  hdy_view_switcher_set_policy (HDY_VIEW_SWITCHER (switcher), HDY_VIEW_SWITCHER_POLICY_WIDE);
+  hdy_view_switcher_set_stack (HDY_VIEW_SWITCHER (switcher), GTK_STACK (stack));
+  gtk_container_add (GTK_CONTAINER (squeezer), switcher);
+
+  switcher = hdy_view_switcher_new ();
+  hdy_view_switcher_set_policy (HDY_VIEW_SWITCHER (switcher), HDY_VIEW_SWITCHER_POLICY_NARROW);
+  hdy_view_switcher_set_stack (HDY_VIEW_SWITCHER (switcher), GTK_STACK (stack));
+  gtk_container_add (GTK_CONTAINER (squeezer), switcher);
+
+  gtk_container_add (GTK_CONTAINER (squeezer), gtk_label_new ("Title"));
+
+  hdy_header_bar_set_custom_title (HDY_HEADER_BAR (header_bar), squeezer);
+  hdy_header_bar_set_show_close_button (HDY_HEADER_BAR (header_bar), TRUE);
+  hdy_header_bar_pack_start (HDY_HEADER_BAR (header_bar),
+                             gtk_button_new_from_icon_name ("go-previous-symbolic", GTK_ICON_SIZE_BUTTON));
+  hdy_header_bar_pack_end (HDY_HEADER_BAR (header_bar),
+                           gtk_button_new_from_icon_name ("open-menu-symbolic", GTK_ICON_SIZE_BUTTON));
+
+  gtk_container_add (GTK_CONTAINER (box), header_bar);
+  gtk_container_add (GTK_CONTAINER (box), stack);
+  gtk_widget_show_all (box);
+
+  return box;
+}
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  g_autoptr (BenchStats) stats = NULL;
+  GtkWidget *window;
+  gint i, width;
+
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  stats = bench_stats_new ("header bar resize sweep");
+  window = bench_window_new (create_content (), stats, MAX_WIDTH, HEIGHT);
+  bench_run_frames (window, 1);
+  bench_stats_reset (stats);
+
+  for (i = 0; i < N_ITERATIONS; i++) {
+    for (width = MAX_WIDTH; width >= MIN_WIDTH; width -= WIDTH_STEP) {
+      gtk_window_resize (GTK_WINDOW (window), width, HEIGHT);
+      bench_run_frames (window, 1);
+    }
+
+    for (width = MIN_WIDTH; width <= MAX_WIDTH; width += WIDTH_STEP) {
+      gtk_window_resize (GTK_WINDOW (window), width, HEIGHT);
+      bench_run_frames (window, 1);
+    }
+  }
+
+  bench_stats_print (stats);
+
+  gtk_widget_destroy (window);
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_ITERATIONS 1000
+
+
+static void
+create_keypad (gpointer user_data)
+{
+  GtkWidget *keypad = g_object_ref_sink (hdy_keypad_new (TRUE, TRUE));
+
+  gtk_widget_destroy (keypad);
+  g_object_unref (keypad);
+}
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  bench_measure ("keypad construction", N_ITERATIONS, create_keypad, NULL);
+
+  return 0;
+}
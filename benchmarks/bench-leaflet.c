@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_CHILDREN 3
+#define N_ITERATIONS 20
+#define CHILD_WIDTH 200
+#define NARROW_WIDTH 300
+#define WIDE_WIDTH 800
+#define HEIGHT 400
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  g_autoptr (BenchStats) stats = NULL;
+  GtkWidget *leaflet, *window;
+  guint duration;
+  gint i;
+
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  leaflet = hdy_leaflet_new ();
+  for (i = 0; i < N_CHILDREN; i++) {
+    GtkWidget *child = gtk_label_new ("Lorem ipsum dolor sit amet");
+
+    gtk_widget_set_size_request (child, CHILD_WIDTH, -1);
+    gtk_widget_show (child);
+    gtk_container_add (GTK_CONTAINER (leaflet), child);
+  }
+  gtk_widget_show (leaflet);
+
+  duration = hdy_leaflet_get_mode_transition_duration (HDY_LEAFLET (leaflet));
+
+  stats = bench_stats_new ("leaflet fold/unfold");
+  window = bench_window_new (leaflet, stats, WIDE_WIDTH, HEIGHT);
+  bench_run_for (duration);
+  bench_stats_reset (stats);
+
+  for (i = 0; i < N_ITERATIONS; i++) {
+    gtk_window_resize (GTK_WINDOW (window), NARROW_WIDTH, HEIGHT);
+    bench_run_for (duration * 2);
+    gtk_window_resize (GTK_WINDOW (window), WIDE_WIDTH, HEIGHT);
+    bench_run_for (duration * 2);
+  }
+
+  bench_stats_print (stats);
+
+  gtk_widget_destroy (window);
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_ITERATIONS 10000
+
+
+static void
+destroy_row (GtkWidget *row)
+{
+  g_object_ref_sink (row);
+  gtk_widget_destroy (row);
+  g_object_unref (row);
+}
+
+
+static void
+create_preferences_row (gpointer user_data)
+{
+  GtkWidget *row = hdy_preferences_row_new ();
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Title");
+  destroy_row (row);
+}
+
+
+static void
+create_action_row (gpointer user_data)
+{
+  GtkWidget *row = hdy_action_row_new ();
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Title");
+  hdy_action_row_set_subtitle (HDY_ACTION_ROW (row), "Subtitle");
+  destroy_row (row);
+}
+
+
+static void
+create_combo_row (gpointer user_data)
+{
+  GtkWidget *row = hdy_combo_row_new ();
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Title");
+  destroy_row (row);
+}
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  /* Each iteration creates a single row, so the number of iterations per
+   * second is the number of rows per second.
+   */
+  bench_measure ("preferences row construction", N_ITERATIONS, create_preferences_row, NULL);
+  bench_measure ("action row construction", N_ITERATIONS, create_action_row, NULL);
+  bench_measure ("combo row construction", N_ITERATIONS, create_combo_row, NULL);
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define HANDY_USE_UNSTABLE_API
+#include <handy.h>
+
+#include "bench-utils.h"
+
+#define N_ITERATIONS 5
+#define MIN_WIDTH 100
+#define MAX_WIDTH 800
+#define WIDTH_STEP 10
+#define HEIGHT 48
+
+static const gint child_widths[] = { 600, 400, 200 };
+
+
+gint
+main (gint argc,
+      gchar *argv[])
+{
+  g_autoptr (BenchStats) stats = NULL;
+  GtkWidget *squeezer, *window;
+  gint i, width;
+
+  gtk_init (&argc, &argv);
+  hdy_init ();
+
+  squeezer = hdy_squeezer_new ();
+  hdy_squeezer_set_transition_type (HDY_SQUEEZER (squeezer),
+                                    HDY_SQUEEZER_TRANSITION_TYPE_CROSSFADE);
+  for (i = 0; i < G_N_ELEMENTS (child_widths); i++) {
+    GtkWidget *child = gtk_label_new ("Lorem ipsum dolor sit amet");
+
+    gtk_widget_set_size_request (child, child_widths[i], -1);
+    gtk_widget_show (child);
+    gtk_container_add (GTK_CONTAINER (squeezer), child);
+  }
+  gtk_widget_show (squeezer);
+
+  stats = bench_stats_new ("squeezer resize sweep");
+  window = bench_window_new (squeezer, stats, MAX_WIDTH, HEIGHT);
+  bench_run_frames (window, 1);
+  bench_stats_reset (stats);
+
+  for (i = 0; i < N_ITERATIONS; i++) {
+    for (width = MAX_WIDTH; width >= MIN_WIDTH; width -= WIDTH_STEP) {
+      gtk_window_resize (GTK_WINDOW (window), width, HEIGHT);
+      bench_run_frames (window, 1);
+    }
+
+    for (width = MIN_WIDTH; width <= MAX_WIDTH; width += WIDTH_STEP) {
+      gtk_window_resize (GTK_WINDOW (window), width, HEIGHT);
+      bench_run_frames (window, 1);
+    }
+  }
+
+  bench_stats_print (stats);
+
+  gtk_widget_destroy (window);
+
+  return 0;
+}
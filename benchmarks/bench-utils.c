@@ -0,0 +1,477 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "bench-utils.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+/* How long to wait for a frame before giving up, in milliseconds. */
+#define FRAME_TIMEOUT 100
+
+#ifdef HAVE_LIBC_MALLOC
+/* glibc exports its allocator under these names too, which allows counting the
+ * allocations made by the whole process by interposing the public ones.
+ */
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb,
+                            size_t size);
+extern void *__libc_realloc (void   *ptr,
+                             size_t  size);
+
+static gint n_allocations = 0;
+
+void *
+malloc (size_t size)
+{
+  g_atomic_int_inc (&n_allocations);
+
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb,
+        size_t size)
+{
+  g_atomic_int_inc (&n_allocations);
+
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void   *ptr,
+         size_t  size)
+{
+  g_atomic_int_inc (&n_allocations);
+
+  return __libc_realloc (ptr, size);
+}
+#endif
+
+struct _BenchStats
+{
+  gchar *name;
+
+  GArray *allocate_times;
+  GArray *draw_times;
+  GArray *allocations;
+
+  /* The frame being currently measured. */
+  gboolean frame_active;
+  gint64 frame_allocate_time;
+  gint64 frame_draw_time;
+  guint frame_allocations;
+};
+
+#define BENCH_TYPE_BIN (bench_bin_get_type())
+
+G_DECLARE_FINAL_TYPE (BenchBin, bench_bin, BENCH, BIN, GtkBin)
+
+/* A bin measuring how long its child takes to be allocated and drawn. */
+struct _BenchBin
+{
+  GtkBin parent_instance;
+
+  BenchStats *stats;
+};
+
+G_DEFINE_TYPE (BenchBin, bench_bin, GTK_TYPE_BIN)
+
+static void
+bench_bin_size_allocate (GtkWidget     *widget,
+                         GtkAllocation *allocation)
+{
+  BenchBin *self = BENCH_BIN (widget);
+  GtkWidget *child = gtk_bin_get_child (GTK_BIN (self));
+  gint64 start;
+
+  gtk_widget_set_allocation (widget, allocation);
+
+  if (child == NULL || !gtk_widget_get_visible (child))
+    return;
+
+  start = bench_get_time_ns ();
+  gtk_widget_size_allocate (child, allocation);
+  self->stats->frame_allocate_time += bench_get_time_ns () - start;
+  self->stats->frame_active = TRUE;
+}
+
+static gboolean
+bench_bin_draw (GtkWidget *widget,
+                cairo_t   *cr)
+{
+  BenchBin *self = BENCH_BIN (widget);
+  gint64 start;
+
+  start = bench_get_time_ns ();
+  GTK_WIDGET_CLASS (bench_bin_parent_class)->draw (widget, cr);
+  self->stats->frame_draw_time += bench_get_time_ns () - start;
+  self->stats->frame_active = TRUE;
+
+  return GDK_EVENT_PROPAGATE;
+}
+
+static void
+bench_bin_class_init (BenchBinClass *klass)
+{
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  widget_class->size_allocate = bench_bin_size_allocate;
+  widget_class->draw = bench_bin_draw;
+}
+
+static void
+bench_bin_init (BenchBin *self)
+{
+}
+
+/**
+ * bench_get_time_ns:
+ *
+ * Returns: the monotonic time, in nanoseconds
+ */
+gint64
+bench_get_time_ns (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return (gint64) ts.tv_sec * G_GINT64_CONSTANT (1000000000) + ts.tv_nsec;
+}
+
+/**
+ * bench_can_count_allocations:
+ *
+ * Returns: whether bench_get_allocation_count() is supported on this platform
+ */
+gboolean
+bench_can_count_allocations (void)
+{
+#ifdef HAVE_LIBC_MALLOC
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * bench_get_allocation_count:
+ *
+ * Returns: the number of memory allocations made by the process so far, or 0
+ *   if they can't be counted
+ */
+guint
+bench_get_allocation_count (void)
+{
+#ifdef HAVE_LIBC_MALLOC
+  return g_atomic_int_get (&n_allocations);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * bench_stats_new:
+ * @name: the name of the benchmark
+ *
+ * Returns: (transfer full): new per-frame statistics
+ */
+BenchStats *
+bench_stats_new (const gchar *name)
+{
+  BenchStats *self = g_new0 (BenchStats, 1);
+
+  self->name = g_strdup (name);
+  self->allocate_times = g_array_new (FALSE, FALSE, sizeof (gint64));
+  self->draw_times = g_array_new (FALSE, FALSE, sizeof (gint64));
+  self->allocations = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  return self;
+}
+
+void
+bench_stats_free (BenchStats *self)
+{
+  g_free (self->name);
+  g_array_unref (self->allocate_times);
+  g_array_unref (self->draw_times);
+  g_array_unref (self->allocations);
+  g_free (self);
+}
+
+/**
+ * bench_stats_reset:
+ * @self: per-frame statistics
+ *
+ * Drops the frames measured so far, e.g. after warming up.
+ */
+void
+bench_stats_reset (BenchStats *self)
+{
+  g_array_set_size (self->allocate_times, 0);
+  g_array_set_size (self->draw_times, 0);
+  g_array_set_size (self->allocations, 0);
+}
+
+static gint
+compare_int64 (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return (x > y) - (x < y);
+}
+
+static gint64
+get_percentile (GArray  *sorted_values,
+                gdouble  percentile)
+{
+  guint index;
+
+  if (sorted_values->len == 0)
+    return 0;
+
+  index = (guint) (percentile * (sorted_values->len - 1) + 0.5);
+
+  return g_array_index (sorted_values, gint64, index);
+}
+
+static void
+print_row (const gchar *name,
+           GArray      *values,
+           gboolean     is_time)
+{
+  g_autoptr (GArray) sorted = g_array_sized_new (FALSE, FALSE, sizeof (gint64), values->len);
+  gint64 p50, p95, p99;
+
+  g_array_append_vals (sorted, values->data, values->len);
+  g_array_sort (sorted, compare_int64);
+
+  p50 = get_percentile (sorted, 0.50);
+  p95 = get_percentile (sorted, 0.95);
+  p99 = get_percentile (sorted, 0.99);
+
+  if (is_time)
+    g_print ("  %-10s %9.3f ms %9.3f ms %9.3f ms\n", name,
+             p50 / 1000000.0, p95 / 1000000.0, p99 / 1000000.0);
+  else
+    g_print ("  %-10s %12" G_GINT64_FORMAT " %12" G_GINT64_FORMAT " %12" G_GINT64_FORMAT "\n",
+             name, p50, p95, p99);
+}
+
+/**
+ * bench_stats_print:
+ * @self: per-frame statistics
+ *
+ * Prints the 50th, 95th and 99th percentiles of the allocation and drawing
+ * times and of the number of memory allocations per frame.
+ */
+void
+bench_stats_print (BenchStats *self)
+{
+  g_print ("%s: %u frames\n", self->name, self->allocate_times->len);
+  g_print ("  %-10s %12s %12s %12s\n", "", "p50", "p95", "p99");
+  print_row ("allocate", self->allocate_times, TRUE);
+  print_row ("draw", self->draw_times, TRUE);
+
+  if (bench_can_count_allocations ())
+    print_row ("mallocs", self->allocations, FALSE);
+}
+
+/**
+ * bench_measure:
+ * @name: the name of the benchmark
+ * @n_iterations: the number of times to call @func
+ * @func: the function to measure
+ * @user_data: the data to pass to @func
+ *
+ * Calls @func @n_iterations times after a warm-up call, then prints the 50th,
+ * 95th and 99th percentiles of the time taken and of the number of memory
+ * allocations per call, and the number of calls per second.
+ */
+void
+bench_measure (const gchar *name,
+               guint        n_iterations,
+               BenchFunc    func,
+               gpointer     user_data)
+{
+  g_autoptr (GArray) times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), n_iterations);
+  g_autoptr (GArray) allocations = g_array_sized_new (FALSE, FALSE, sizeof (gint64), n_iterations);
+  gint64 total_time = 0;
+  guint i;
+
+  /* Warm up, e.g. to initialize the classes and load the theme. */
+  func (user_data);
+
+  for (i = 0; i < n_iterations; i++) {
+    guint start_allocations = bench_get_allocation_count ();
+    gint64 start = bench_get_time_ns ();
+    gint64 time, allocated;
+
+    func (user_data);
+
+    time = bench_get_time_ns () - start;
+    allocated = bench_get_allocation_count () - start_allocations;
+    total_time += time;
+
+    g_array_append_val (times, time);
+    g_array_append_val (allocations, allocated);
+  }
+
+  g_print ("%s: %u iterations, %.1f per second\n", name, n_iterations,
+           total_time > 0 ? n_iterations * 1000000000.0 / total_time : 0.0);
+  g_print ("  %-10s %12s %12s %12s\n", "", "p50", "p95", "p99");
+  print_row ("time", times, TRUE);
+
+  if (bench_can_count_allocations ())
+    print_row ("mallocs", allocations, FALSE);
+}
+
+static void
+before_paint_cb (GdkFrameClock *frame_clock,
+                 BenchStats    *stats)
+{
+  stats->frame_active = FALSE;
+  stats->frame_allocate_time = 0;
+  stats->frame_draw_time = 0;
+  stats->frame_allocations = bench_get_allocation_count ();
+}
+
+static void
+after_paint_cb (GdkFrameClock *frame_clock,
+                BenchStats    *stats)
+{
+  gint64 allocations;
+
+  /* Ignore the frames that didn't involve the measured widget. */
+  if (!stats->frame_active)
+    return;
+
+  allocations = bench_get_allocation_count () - stats->frame_allocations;
+
+  g_array_append_val (stats->allocate_times, stats->frame_allocate_time);
+  g_array_append_val (stats->draw_times, stats->frame_draw_time);
+  g_array_append_val (stats->allocations, allocations);
+}
+
+/**
+ * bench_window_new:
+ * @widget: the widget to measure
+ * @stats: the statistics to fill, it must outlive the window
+ * @width: the initial width of the window
+ * @height: the initial height of the window
+ *
+ * Creates and shows a window containing @widget, recording the time taken to
+ * allocate and draw @widget and the number of memory allocations for every
+ * frame into @stats.
+ *
+ * Returns: (transfer none): the new window
+ */
+GtkWidget *
+bench_window_new (GtkWidget  *widget,
+                  BenchStats *stats,
+                  gint        width,
+                  gint        height)
+{
+  GtkWidget *window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  BenchBin *bin = g_object_new (BENCH_TYPE_BIN, "visible", TRUE, NULL);
+  GdkFrameClock *frame_clock;
+
+  bin->stats = stats;
+
+  gtk_container_add (GTK_CONTAINER (bin), widget);
+  gtk_container_add (GTK_CONTAINER (window), GTK_WIDGET (bin));
+  gtk_window_set_default_size (GTK_WINDOW (window), width, height);
+  gtk_widget_show (window);
+
+  frame_clock = gtk_widget_get_frame_clock (window);
+  g_signal_connect (frame_clock, "before-paint", G_CALLBACK (before_paint_cb), stats);
+  g_signal_connect (frame_clock, "after-paint", G_CALLBACK (after_paint_cb), stats);
+
+  return window;
+}
+
+typedef struct {
+  GMainLoop *loop;
+  guint n_frames;
+  guint timeout_id;
+} RunData;
+
+static gboolean
+run_timeout_cb (RunData *data)
+{
+  data->timeout_id = 0;
+  g_main_loop_quit (data->loop);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+run_frame_cb (GdkFrameClock *frame_clock,
+              RunData       *data)
+{
+  if (data->n_frames > 0)
+    data->n_frames--;
+
+  if (data->n_frames == 0)
+    g_main_loop_quit (data->loop);
+}
+
+/**
+ * bench_run_for:
+ * @duration: the duration, in milliseconds
+ *
+ * Runs the main loop for @duration milliseconds, e.g. to let a transition run
+ * to its end.
+ */
+void
+bench_run_for (guint duration)
+{
+  RunData data = { NULL, 0, 0 };
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  data.timeout_id = g_timeout_add (duration, (GSourceFunc) run_timeout_cb, &data);
+
+  g_main_loop_run (data.loop);
+
+  g_main_loop_unref (data.loop);
+}
+
+/**
+ * bench_run_frames:
+ * @window: a window created with bench_window_new()
+ * @n_frames: the number of frames
+ *
+ * Runs the main loop until @window painted @n_frames frames, or until it
+ * looks like no more frames will come.
+ */
+void
+bench_run_frames (GtkWidget *window,
+                  guint      n_frames)
+{
+  GdkFrameClock *frame_clock = gtk_widget_get_frame_clock (window);
+  RunData data = { NULL, 0, 0 };
+  gulong handler_id;
+
+  if (n_frames == 0)
+    return;
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  data.n_frames = n_frames;
+  data.timeout_id = g_timeout_add (FRAME_TIMEOUT * n_frames,
+                                   (GSourceFunc) run_timeout_cb, &data);
+  handler_id = g_signal_connect (frame_clock, "after-paint",
+                                 G_CALLBACK (run_frame_cb), &data);
+
+  g_main_loop_run (data.loop);
+
+  g_signal_handler_disconnect (frame_clock, handler_id);
+  if (data.timeout_id)
+    g_source_remove (data.timeout_id);
+  g_main_loop_unref (data.loop);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _BenchStats BenchStats;
+
+BenchStats *bench_stats_new   (const gchar *name);
+void        bench_stats_free  (BenchStats  *self);
+void        bench_stats_reset (BenchStats  *self);
+void        bench_stats_print (BenchStats  *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (BenchStats, bench_stats_free)
+
+gint64      bench_get_time_ns          (void);
+gboolean    bench_can_count_allocations (void);
+guint       bench_get_allocation_count (void);
+
+GtkWidget  *bench_window_new  (GtkWidget  *widget,
+                               BenchStats *stats,
+                               gint        width,
+                               gint        height);
+void        bench_run_for     (guint       duration);
+void        bench_run_frames  (GtkWidget  *window,
+                               guint       n_frames);
+
+typedef void (*BenchFunc) (gpointer user_data);
+
+void        bench_measure     (const gchar *name,
+                               guint        n_iterations,
+                               BenchFunc    func,
+                               gpointer     user_data);
+
+G_END_DECLS
@@ -39,7 +39,9 @@
  * for the vertical box containing the title and subtitle labels.
  *
  * It contains subnodes label.title and label.subtitle representing respectively
- * the title label and subtitle label.
+ * the title label and subtitle label. The label.subtitle subnode, the icon and
+ * the boxes holding the prefix and suffix widgets are only created once they
+ * are needed.
  *
  * Since: 0.0.6
  */
@@ -114,14 +116,101 @@ parent_cb (HdyActionRow *self)
   g_signal_connect_swapped (parent, "row-activated", G_CALLBACK (row_activated_cb), self);
 }
 
+static GtkLabel *
+create_label (const gchar *style_class)
+{
+  GtkWidget *label = gtk_label_new (NULL);
+
+  gtk_label_set_ellipsize (GTK_LABEL (label), PANGO_ELLIPSIZE_END);
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+  gtk_widget_set_halign (label, GTK_ALIGN_START);
+  gtk_widget_set_hexpand (label, TRUE);
+  gtk_style_context_add_class (gtk_widget_get_style_context (label), style_class);
+
+  return GTK_LABEL (label);
+}
+
+static void
+title_cb (HdyActionRow *self)
+{
+  HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
+  const gchar *title = hdy_preferences_row_get_title (HDY_PREFERENCES_ROW (self));
+
+  gtk_label_set_label (priv->title, title);
+  gtk_widget_set_visible (GTK_WIDGET (priv->title),
+                          title != NULL && g_strcmp0 (title, "") != 0);
+}
+
+static GtkBox *
+create_affixes_box (void)
+{
+  GtkWidget *box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 12);
+
+  gtk_widget_set_no_show_all (box, TRUE);
+
+  return GTK_BOX (box);
+}
+
+/* Most rows only have a title, so the prefixes box, the image, the subtitle
+ * label and the suffixes box are only created when they are first needed.
+ */
+static void
+ensure_prefixes (HdyActionRow *self)
+{
+  HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
+
+  if (priv->prefixes)
+    return;
+
+  priv->prefixes = create_affixes_box ();
+  gtk_container_add (GTK_CONTAINER (priv->header), GTK_WIDGET (priv->prefixes));
+  gtk_box_reorder_child (priv->header, GTK_WIDGET (priv->prefixes), 0);
+}
+
+static void
+ensure_image (HdyActionRow *self)
+{
+  HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
+
+  if (priv->image)
+    return;
+
+  priv->image = GTK_IMAGE (gtk_image_new ());
+  gtk_image_set_pixel_size (priv->image, 32);
+  gtk_widget_set_no_show_all (GTK_WIDGET (priv->image), TRUE);
+  gtk_widget_set_valign (GTK_WIDGET (priv->image), GTK_ALIGN_CENTER);
+  gtk_container_add (GTK_CONTAINER (priv->header), GTK_WIDGET (priv->image));
+  gtk_box_reorder_child (priv->header, GTK_WIDGET (priv->image),
+                         priv->prefixes ? 1 : 0);
+}
+
+static void
+ensure_subtitle (HdyActionRow *self)
+{
+  HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
+
+  if (priv->subtitle)
+    return;
+
+  priv->subtitle = create_label ("subtitle");
+  gtk_container_add (GTK_CONTAINER (priv->title_box), GTK_WIDGET (priv->subtitle));
+
+  if (priv->use_underline) {
+    gtk_label_set_use_underline (priv->subtitle, TRUE);
+    gtk_label_set_mnemonic_widget (priv->subtitle, GTK_WIDGET (self));
+  }
+}
+
 static void
-update_subtitle_visibility (HdyActionRow *self)
+ensure_suffixes (HdyActionRow *self)
 {
   HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
 
-  gtk_widget_set_visible (GTK_WIDGET (priv->subtitle),
-                          gtk_label_get_text (priv->subtitle) != NULL &&
-                          g_strcmp0 (gtk_label_get_text (priv->subtitle), "") != 0);
+  if (priv->suffixes)
+    return;
+
+  priv->suffixes = create_affixes_box ();
+  gtk_box_pack_end (priv->header, GTK_WIDGET (priv->suffixes), FALSE, TRUE, 0);
 }
 
 static void
@@ -200,13 +289,15 @@ hdy_action_row_show_all (GtkWidget *widget)
 
   priv = hdy_action_row_get_instance_private (self);
 
-  gtk_container_foreach (GTK_CONTAINER (priv->prefixes),
-                         (GtkCallback) gtk_widget_show_all,
-                         NULL);
+  if (priv->prefixes)
+    gtk_container_foreach (GTK_CONTAINER (priv->prefixes),
+                           (GtkCallback) gtk_widget_show_all,
+                           NULL);
 
-  gtk_container_foreach (GTK_CONTAINER (priv->suffixes),
-                         (GtkCallback) gtk_widget_show_all,
-                         NULL);
+  if (priv->suffixes)
+    gtk_container_foreach (GTK_CONTAINER (priv->suffixes),
+                           (GtkCallback) gtk_widget_show_all,
+                           NULL);
 
   GTK_WIDGET_CLASS (hdy_action_row_parent_class)->show_all (widget);
 }
@@ -224,7 +315,9 @@ hdy_action_row_destroy (GtkWidget *widget)
 
   hdy_action_row_set_activatable_widget (self, NULL);
 
+  priv->image = NULL;
   priv->prefixes = NULL;
+  priv->subtitle = NULL;
   priv->suffixes = NULL;
 
   GTK_WIDGET_CLASS (hdy_action_row_parent_class)->destroy (widget);
@@ -243,6 +336,7 @@ hdy_action_row_add (GtkContainer *container,
   if (priv->header == NULL)
     GTK_CONTAINER_CLASS (hdy_action_row_parent_class)->add (container, child);
   else {
+    ensure_suffixes (self);
     gtk_container_add (GTK_CONTAINER (priv->suffixes), child);
     gtk_widget_show (GTK_WIDGET (priv->suffixes));
   }
@@ -257,9 +351,9 @@ hdy_action_row_remove (GtkContainer *container,
 
   if (child == GTK_WIDGET (priv->header))
     GTK_CONTAINER_CLASS (hdy_action_row_parent_class)->remove (container, child);
-  else if (gtk_widget_get_parent (child) == GTK_WIDGET (priv->prefixes))
+  else if (priv->prefixes && gtk_widget_get_parent (child) == GTK_WIDGET (priv->prefixes))
     gtk_container_remove (GTK_CONTAINER (priv->prefixes), child);
-  else
+  else if (priv->suffixes)
     gtk_container_remove (GTK_CONTAINER (priv->suffixes), child);
 }
 
@@ -417,45 +511,45 @@ hdy_action_row_class_init (HdyActionRowClass *klass)
                   NULL, NULL, NULL,
                   G_TYPE_NONE,
                   0);
-
-  gtk_widget_class_set_template_from_resource (widget_class,
-                                               "/sm/puri/handy/ui/hdy-action-row.ui");
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, header);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, image);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, prefixes);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, subtitle);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, suffixes);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, title);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyActionRow, title_box);
-}
-
-static gboolean
-string_is_not_empty (GBinding     *binding,
-                     const GValue *from_value,
-                     GValue       *to_value,
-                     gpointer      user_data)
-{
-  const gchar *string = g_value_get_string (from_value);
-
-  g_value_set_boolean (to_value, string != NULL && g_strcmp0 (string, "") != 0);
-
-  return TRUE;
 }
 
 static void
 hdy_action_row_init (HdyActionRow *self)
 {
   HdyActionRowPrivate *priv = hdy_action_row_get_instance_private (self);
+  GtkWidget *header;
 
-  gtk_widget_init_template (GTK_WIDGET (self));
-
-  g_object_bind_property_full (self, "title", priv->title, "visible", G_BINDING_SYNC_CREATE,
-                               string_is_not_empty, NULL, NULL, NULL);
+  /* The widget tree is built in code rather than from a template, as rows are
+   * created in large numbers and parsing a template for each of them is slow.
+   */
+  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (self), FALSE);
+
+  header = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 12);
+  gtk_widget_set_valign (header, GTK_ALIGN_CENTER);
+  gtk_style_context_add_class (gtk_widget_get_style_context (header), "header");
+  gtk_widget_show (header);
+
+  priv->title_box = GTK_BOX (gtk_box_new (GTK_ORIENTATION_VERTICAL, 0));
+  gtk_widget_set_no_show_all (GTK_WIDGET (priv->title_box), TRUE);
+  gtk_widget_set_halign (GTK_WIDGET (priv->title_box), GTK_ALIGN_START);
+  gtk_widget_set_valign (GTK_WIDGET (priv->title_box), GTK_ALIGN_CENTER);
+  gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (priv->title_box)), "title");
+  gtk_widget_show (GTK_WIDGET (priv->title_box));
+  gtk_container_add (GTK_CONTAINER (header), GTK_WIDGET (priv->title_box));
+
+  priv->title = create_label ("title");
+  gtk_container_add (GTK_CONTAINER (priv->title_box), GTK_WIDGET (priv->title));
+
+  /* Add the header as the child of the GtkListBoxRow before setting it, see
+   * hdy_action_row_add().
+   */
+  gtk_container_add (GTK_CONTAINER (self), header);
+  priv->header = GTK_BOX (header);
 
-  update_subtitle_visibility (self);
+  title_cb (self);
 
+  g_signal_connect (self, "notify::title", G_CALLBACK (title_cb), NULL);
   g_signal_connect (self, "notify::parent", G_CALLBACK (parent_cb), NULL);
-
 }
 
 static void
@@ -516,7 +610,7 @@ hdy_action_row_get_subtitle (HdyActionRow *self)
 
   priv = hdy_action_row_get_instance_private (self);
 
-  return gtk_label_get_text (priv->subtitle);
+  return priv->subtitle ? gtk_label_get_text (priv->subtitle) : "";
 }
 
 /**
@@ -538,12 +632,15 @@ hdy_action_row_set_subtitle (HdyActionRow *self,
 
   priv = hdy_action_row_get_instance_private (self);
 
-  if (g_strcmp0 (gtk_label_get_text (priv->subtitle), subtitle) == 0)
+  if (g_strcmp0 (hdy_action_row_get_subtitle (self), subtitle) == 0)
     return;
 
-  gtk_label_set_text (priv->subtitle, subtitle);
-  gtk_widget_set_visible (GTK_WIDGET (priv->subtitle),
-                          subtitle != NULL && g_strcmp0 (subtitle, "") != 0);
+  if (priv->subtitle || (subtitle != NULL && g_strcmp0 (subtitle, "") != 0)) {
+    ensure_subtitle (self);
+    gtk_label_set_text (priv->subtitle, subtitle);
+    gtk_widget_set_visible (GTK_WIDGET (priv->subtitle),
+                            subtitle != NULL && g_strcmp0 (subtitle, "") != 0);
+  }
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SUBTITLE]);
 }
@@ -568,6 +665,9 @@ hdy_action_row_get_icon_name (HdyActionRow *self)
 
   priv = hdy_action_row_get_instance_private (self);
 
+  if (priv->image == NULL)
+    return NULL;
+
   gtk_image_get_icon_name (priv->image, &icon_name, NULL);
 
   return icon_name;
@@ -593,13 +693,16 @@ hdy_action_row_set_icon_name (HdyActionRow *self,
 
   priv = hdy_action_row_get_instance_private (self);
 
-  gtk_image_get_icon_name (priv->image, &old_icon_name, NULL);
+  old_icon_name = hdy_action_row_get_icon_name (self);
   if (g_strcmp0 (old_icon_name, icon_name) == 0)
     return;
 
-  gtk_image_set_from_icon_name (priv->image, icon_name, GTK_ICON_SIZE_INVALID);
-  gtk_widget_set_visible (GTK_WIDGET (priv->image),
-                          icon_name != NULL && g_strcmp0 (icon_name, "") != 0);
+  if (priv->image || (icon_name != NULL && g_strcmp0 (icon_name, "") != 0)) {
+    ensure_image (self);
+    gtk_image_set_from_icon_name (priv->image, icon_name, GTK_ICON_SIZE_INVALID);
+    gtk_widget_set_visible (GTK_WIDGET (priv->image),
+                            icon_name != NULL && g_strcmp0 (icon_name, "") != 0);
+  }
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ICON_NAME]);
 }
@@ -734,9 +837,11 @@ hdy_action_row_set_use_underline (HdyActionRow *self,
   priv->use_underline = !!use_underline;
   hdy_preferences_row_set_use_underline (HDY_PREFERENCES_ROW (self), priv->use_underline);
   gtk_label_set_use_underline (priv->title, priv->use_underline);
-  gtk_label_set_use_underline (priv->subtitle, priv->use_underline);
   gtk_label_set_mnemonic_widget (priv->title, GTK_WIDGET (self));
-  gtk_label_set_mnemonic_widget (priv->subtitle, GTK_WIDGET (self));
+  if (priv->subtitle) {
+    gtk_label_set_use_underline (priv->subtitle, priv->use_underline);
+    gtk_label_set_mnemonic_widget (priv->subtitle, GTK_WIDGET (self));
+  }
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_USE_UNDERLINE]);
 }
@@ -761,6 +866,7 @@ hdy_action_row_add_prefix (HdyActionRow *self,
 
   priv = hdy_action_row_get_instance_private (self);
 
+  ensure_prefixes (self);
   gtk_box_pack_start (priv->prefixes, widget, FALSE, TRUE, 0);
   gtk_widget_show (GTK_WIDGET (priv->prefixes));
 }
@@ -29,8 +29,9 @@
  * #HdyComboRow has a main CSS node with name row.
  *
  * Its popover has the node name popover with the .combo style class, it
- * contains a #GtkScrolledWindow, which in turn contains a #GtkListBox, both are
- * accessible via their regular nodes.
+ * contains a #GtkSearchEntry which is only visible when
+ * #HdyComboRow:filter-enabled is %TRUE, and a #GtkScrolledWindow, which in turn
+ * contains a #GtkListBox, all are accessible via their regular nodes.
  *
  * A checkmark of node and style class image.checkmark in the popover denotes
  * the current item.
@@ -42,6 +43,11 @@
  * This was mostly inspired by code from the display panel from GNOME Settings.
  */
 
+/* How many rows of the virtual list are created above and below the visible
+ * ones, so scrolling a bit or moving the focus doesn't expose missing rows.
+ */
+#define VIRTUAL_LIST_MARGIN 10
+
 typedef struct
 {
   HdyComboRowGetNameFunc func;
@@ -55,17 +61,33 @@ typedef struct
   GtkImage *image;
   GtkListBox *list;
   GtkPopover *popover;
+  GtkSearchEntry *filter_entry;
+  GtkScrolledWindow *scrolled_window;
+  GtkWidget *viewport;
+  GtkWidget *layout;
   gint selected_index;
   gboolean use_subtitle;
+  gboolean virtual_list;
+  gboolean filter_enabled;
   HdyComboRowGetName *get_name;
 
   GListModel *bound_model;
+  gboolean list_bound;
+  GtkWidget *selected_checkmark;
+  GObject *current_item;
+  GPtrArray *virtual_rows;
+  gint virtual_row_height;
+  gint virtual_list_width;
+  gint virtual_list_first;
+  gint virtual_list_n_shown;
+  GPtrArray *name_keys;
+  GArray *filtered;
   GtkListBoxCreateWidgetFunc create_list_widget_func;
   GtkListBoxCreateWidgetFunc create_current_widget_func;
   gpointer create_widget_func_data;
   GDestroyNotify create_widget_func_data_free_func;
-  /* This is owned by create_widget_func_data, which is ultimately owned by the
-   * list box, and hence should not be destroyed manually.
+  /* This is owned by create_widget_func_data, and hence should not be
+   * destroyed manually.
    */
   HdyComboRowGetName *get_name_internal;
 } HdyComboRowPrivate;
@@ -76,6 +98,8 @@ enum {
   PROP_0,
   PROP_SELECTED_INDEX,
   PROP_USE_SUBTITLE,
+  PROP_VIRTUAL_LIST,
+  PROP_FILTER_ENABLED,
   LAST_PROP,
 };
 
@@ -118,16 +142,6 @@ create_current_label (gpointer item,
                         NULL);
 }
 
-static void
-create_list_widget_data_free (gpointer user_data)
-{
-  HdyComboRow *self = HDY_COMBO_ROW (user_data);
-  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
-
-  if (priv->create_widget_func_data_free_func)
-    priv->create_widget_func_data_free_func (priv->create_widget_func_data);
-}
-
 static GtkWidget *
 create_list_widget (gpointer item,
                     gpointer user_data)
@@ -139,8 +153,9 @@ create_list_widget (gpointer item,
                                        "icon-name", "emblem-ok-symbolic",
                                        "valign", GTK_ALIGN_CENTER,
                                        NULL);
+  GtkWidget *item_widget = priv->create_list_widget_func (item, priv->create_widget_func_data);
   GtkWidget *box = g_object_new (GTK_TYPE_BOX,
-                                 "child", priv->create_list_widget_func (item, priv->create_widget_func_data),
+                                 "child", item_widget,
                                  "child", checkmark,
                                  "halign", GTK_ALIGN_START,
                                  "spacing", 6,
@@ -152,10 +167,26 @@ create_list_widget (gpointer item,
   gtk_style_context_add_class (checkmark_context, "checkmark");
 
   g_object_set_data (G_OBJECT (box), "checkmark", checkmark);
+  g_object_set_data (G_OBJECT (box), "item-widget", item_widget);
 
   return box;
 }
 
+static gchar *
+get_item_name (HdyComboRow *self,
+               gpointer     item)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->get_name != NULL && priv->get_name->func)
+    return priv->get_name->func (item, priv->get_name->func_data);
+
+  if (priv->get_name_internal != NULL && priv->get_name_internal->func)
+    return priv->get_name_internal->func (item, priv->get_name_internal->func_data);
+
+  return NULL;
+}
+
 static void
 get_name_free (HdyComboRowGetName *get_name)
 {
@@ -171,18 +202,96 @@ get_name_free (HdyComboRowGetName *get_name)
   g_free (get_name);
 }
 
+/* Only the checkmark of the previously selected item and the one of the newly
+ * selected item are updated, rather than the ones of every item.
+ */
+static void
+set_selected_checkmark (HdyComboRow *self,
+                        GtkWidget   *checkmark)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->selected_checkmark == checkmark)
+    return;
+
+  if (priv->selected_checkmark) {
+    gtk_widget_hide (priv->selected_checkmark);
+    g_object_remove_weak_pointer (G_OBJECT (priv->selected_checkmark),
+                                  (gpointer *) &priv->selected_checkmark);
+  }
+
+  priv->selected_checkmark = checkmark;
+
+  if (priv->selected_checkmark) {
+    g_object_add_weak_pointer (G_OBJECT (priv->selected_checkmark),
+                               (gpointer *) &priv->selected_checkmark);
+    gtk_widget_show (priv->selected_checkmark);
+  }
+}
+
+static GtkListBoxRow *
+get_virtual_row_for_position (HdyComboRow *self,
+                              gint         position)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  for (guint i = 0; i < priv->virtual_rows->len; i++) {
+    GObject *row = g_ptr_array_index (priv->virtual_rows, i);
+
+    if (GPOINTER_TO_INT (g_object_get_data (row, "index")) >= 0 &&
+        GPOINTER_TO_INT (g_object_get_data (row, "position")) == position)
+      return GTK_LIST_BOX_ROW (row);
+  }
+
+  return NULL;
+}
+
+static void
+update_checkmark (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  GtkListBoxRow *row = NULL;
+
+  if (priv->list_bound && priv->selected_index >= 0) {
+    if (priv->virtual_list)
+      row = get_virtual_row_for_position (self, priv->selected_index);
+    else
+      row = gtk_list_box_get_row_at_index (priv->list, priv->selected_index);
+  }
+
+  set_selected_checkmark (self, row != NULL ? g_object_get_data (G_OBJECT (gtk_bin_get_child (GTK_BIN (row))), "checkmark") : NULL);
+}
+
+/* The current widget is only recreated when the current item changes. */
+static void
+set_current_item (HdyComboRow *self,
+                  GObject     *item)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->current_item == item)
+    return;
+
+  gtk_container_foreach (GTK_CONTAINER (priv->current), (GtkCallback) gtk_widget_destroy, NULL);
+  g_set_object (&priv->current_item, item);
+
+  if (item)
+    gtk_container_add (GTK_CONTAINER (priv->current),
+                       priv->create_current_widget_func (item, priv->create_widget_func_data));
+}
+
 static void
 update (HdyComboRow *self)
 {
   HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
   g_autoptr(GObject) item = NULL;
   g_autofree gchar *name = NULL;
-  GtkWidget *widget;
 
   gtk_widget_set_visible (GTK_WIDGET (priv->current), !priv->use_subtitle);
-  gtk_container_foreach (GTK_CONTAINER (priv->current), (GtkCallback) gtk_widget_destroy, NULL);
 
   if (priv->bound_model == NULL || g_list_model_get_n_items (priv->bound_model) == 0) {
+    set_current_item (self, NULL);
+    set_selected_checkmark (self, NULL);
     gtk_widget_set_sensitive (GTK_WIDGET (self), FALSE);
     g_assert (priv->selected_index == -1);
 
@@ -193,32 +302,346 @@ update (HdyComboRow *self)
 
   gtk_widget_set_sensitive (GTK_WIDGET (self), TRUE);
 
-  {
-    g_autoptr (GList) rows = gtk_container_get_children (GTK_CONTAINER (priv->list));
-    GList *l;
-    int i = 0;
-
-    for (l = rows; l; l = l->next) {
-      GtkWidget *row = GTK_WIDGET (l->data);
-      GtkWidget *box = gtk_bin_get_child (GTK_BIN (row));
-
-      gtk_widget_set_visible (GTK_WIDGET (g_object_get_data (G_OBJECT (box), "checkmark")),
-                              priv->selected_index == i++);
-    }
-  }
+  update_checkmark (self);
 
   item = g_list_model_get_item (priv->bound_model, priv->selected_index);
   if (priv->use_subtitle) {
-    if (priv->get_name != NULL && priv->get_name->func)
-      name = priv->get_name->func (item, priv->get_name->func_data);
-    else if (priv->get_name_internal != NULL && priv->get_name_internal->func)
-      name = priv->get_name_internal->func (item, priv->get_name_internal->func_data);
+    set_current_item (self, NULL);
+    name = get_item_name (self, item);
     hdy_action_row_set_subtitle (HDY_ACTION_ROW (self), name);
   }
-  else {
-    widget = priv->create_current_widget_func (item, priv->create_widget_func_data);
-    gtk_container_add (GTK_CONTAINER (priv->current), widget);
+  else
+    set_current_item (self, item);
+}
+
+static guint
+get_n_shown_items (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->filtered)
+    return priv->filtered->len;
+
+  return g_list_model_get_n_items (priv->bound_model);
+}
+
+static guint
+get_shown_item_position (HdyComboRow *self,
+                         guint        index)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->filtered)
+    return g_array_index (priv->filtered, guint, index);
+
+  return index;
+}
+
+/* Binds a recycled row of the virtual list to the item shown at @index. */
+static void
+bind_virtual_row (HdyComboRow   *self,
+                  GtkListBoxRow *row,
+                  gint           index)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  g_autoptr (GObject) item = NULL;
+  GtkWidget *box = gtk_bin_get_child (GTK_BIN (row));
+  GtkWidget *checkmark;
+  guint position;
+
+  if (GPOINTER_TO_INT (g_object_get_data (G_OBJECT (row), "index")) == index)
+    return;
+
+  position = get_shown_item_position (self, index);
+  item = g_list_model_get_item (priv->bound_model, position);
+
+  /* The labels of named items can be reused, other item widgets can't. */
+  if (box != NULL && priv->create_list_widget_func == create_list_label) {
+    g_autofree gchar *name = get_item_name (self, item);
+
+    gtk_label_set_label (GTK_LABEL (g_object_get_data (G_OBJECT (box), "item-widget")), name);
+  } else {
+    if (box != NULL)
+      gtk_widget_destroy (box);
+
+    box = create_list_widget (item, self);
+    gtk_container_add (GTK_CONTAINER (row), box);
+  }
+
+  g_object_set_data (G_OBJECT (row), "index", GINT_TO_POINTER (index));
+  g_object_set_data (G_OBJECT (row), "position", GINT_TO_POINTER (position));
+
+  checkmark = g_object_get_data (G_OBJECT (box), "checkmark");
+  if (position == priv->selected_index)
+    set_selected_checkmark (self, checkmark);
+  else if (checkmark == priv->selected_checkmark)
+    set_selected_checkmark (self, NULL);
+
+  gtk_widget_show (GTK_WIDGET (row));
+  gtk_list_box_row_changed (row);
+}
+
+static void
+unbind_virtual_row (HdyComboRow   *self,
+                    GtkListBoxRow *row)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  GtkWidget *box = gtk_bin_get_child (GTK_BIN (row));
+
+  if (box != NULL && g_object_get_data (G_OBJECT (box), "checkmark") == priv->selected_checkmark)
+    set_selected_checkmark (self, NULL);
+
+  g_object_set_data (G_OBJECT (row), "index", GINT_TO_POINTER (-1));
+  gtk_widget_hide (GTK_WIDGET (row));
+}
+
+static void
+unbind_virtual_rows (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  for (guint i = 0; i < priv->virtual_rows->len; i++)
+    unbind_virtual_row (self, g_ptr_array_index (priv->virtual_rows, i));
+}
+
+static GtkListBoxRow *
+create_virtual_row (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  GtkWidget *row = gtk_list_box_row_new ();
+
+  g_object_set_data (G_OBJECT (row), "index", GINT_TO_POINTER (-1));
+  gtk_container_add (GTK_CONTAINER (priv->list), row);
+  g_ptr_array_add (priv->virtual_rows, row);
+
+  return GTK_LIST_BOX_ROW (row);
+}
+
+static gint
+sort_virtual_rows (GtkListBoxRow *a,
+                   GtkListBoxRow *b,
+                   gpointer       user_data)
+{
+  gint index_a = GPOINTER_TO_INT (g_object_get_data (G_OBJECT (a), "index"));
+  gint index_b = GPOINTER_TO_INT (g_object_get_data (G_OBJECT (b), "index"));
+
+  return index_a < index_b ? -1 : index_a > index_b;
+}
+
+/* The virtual list only has rows for the shown items in the visible range and
+ * a margin around it. They are kept in a ring indexed by the position of their
+ * item modulo its length, so scrolling only rebinds the rows of the items
+ * entering the range. All rows are assumed to be as high as the first one.
+ */
+static void
+update_virtual_rows (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  GtkAdjustment *adjustment;
+  gdouble value, page_size;
+  gint first, last, n_shown, n_rows, width;
+
+  if (!priv->virtual_list || !priv->list_bound)
+    return;
+
+  n_shown = get_n_shown_items (self);
+
+  if (priv->virtual_row_height <= 0 && n_shown > 0) {
+    GtkListBoxRow *row = priv->virtual_rows->len > 0 ?
+      g_ptr_array_index (priv->virtual_rows, 0) : create_virtual_row (self);
+
+    bind_virtual_row (self, row, 0);
+    gtk_widget_get_preferred_height (GTK_WIDGET (row), NULL, &priv->virtual_row_height);
+    priv->virtual_row_height = MAX (priv->virtual_row_height, 1);
+  }
+
+  adjustment = gtk_scrolled_window_get_vadjustment (priv->scrolled_window);
+  value = gtk_adjustment_get_value (adjustment);
+  page_size = gtk_adjustment_get_page_size (adjustment);
+
+  /* The adjustment isn't configured before the list is first allocated. */
+  if (page_size <= 0)
+    page_size = gtk_scrolled_window_get_max_content_height (priv->scrolled_window);
+
+  first = 0;
+  last = 0;
+  if (n_shown > 0) {
+    first = CLAMP ((gint) (value / priv->virtual_row_height) - VIRTUAL_LIST_MARGIN, 0, n_shown);
+    last = CLAMP ((gint) ((value + page_size) / priv->virtual_row_height) + 1 + VIRTUAL_LIST_MARGIN, first, n_shown);
+  }
+  n_rows = last - first;
+
+  while (priv->virtual_rows->len < (guint) n_rows)
+    create_virtual_row (self);
+
+  for (gint i = first; i < last; i++)
+    bind_virtual_row (self, g_ptr_array_index (priv->virtual_rows, i % priv->virtual_rows->len), i);
+
+  for (guint i = n_rows; i < priv->virtual_rows->len; i++)
+    unbind_virtual_row (self, g_ptr_array_index (priv->virtual_rows, (first + i) % priv->virtual_rows->len));
+
+  /* Keep the widest width seen so far, so the popover doesn't resize while
+   * scrolling.
+   */
+  gtk_widget_get_preferred_width (GTK_WIDGET (priv->list), NULL, &width);
+  width = MAX (priv->virtual_list_width, width);
+
+  /* Most scroll steps don't change the range, so don't queue a resize for
+   * nothing.
+   */
+  if (width != priv->virtual_list_width || n_shown != priv->virtual_list_n_shown) {
+    priv->virtual_list_width = width;
+    priv->virtual_list_n_shown = n_shown;
+
+    gtk_widget_set_size_request (GTK_WIDGET (priv->list), width, -1);
+    gtk_widget_set_size_request (priv->layout, width, n_shown * priv->virtual_row_height);
+    gtk_layout_set_size (GTK_LAYOUT (priv->layout), width, n_shown * priv->virtual_row_height);
+  }
+
+  if (first != priv->virtual_list_first) {
+    priv->virtual_list_first = first;
+
+    gtk_layout_move (GTK_LAYOUT (priv->layout), GTK_WIDGET (priv->list), 0, first * priv->virtual_row_height);
+  }
+}
+
+/* The list box would scroll to the focused row using its allocation in the
+ * list, which only holds the rows around the visible range, so scroll to the
+ * position of its item in the whole list instead.
+ */
+static void
+list_set_focus_child_cb (HdyComboRow *self,
+                         GtkWidget   *child)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  gint index;
+
+  if (!priv->virtual_list || child == NULL || priv->virtual_row_height <= 0)
+    return;
+
+  index = GPOINTER_TO_INT (g_object_get_data (G_OBJECT (child), "index"));
+  if (index < 0)
+    return;
+
+  gtk_adjustment_clamp_page (gtk_scrolled_window_get_vadjustment (priv->scrolled_window),
+                             index * priv->virtual_row_height,
+                             (index + 1) * priv->virtual_row_height);
+}
+
+static void
+clear_virtual_rows (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  unbind_virtual_rows (self);
+
+  for (guint i = 0; i < priv->virtual_rows->len; i++)
+    gtk_widget_destroy (g_ptr_array_index (priv->virtual_rows, i));
+
+  g_ptr_array_set_size (priv->virtual_rows, 0);
+  priv->virtual_row_height = 0;
+  priv->virtual_list_width = 0;
+  priv->virtual_list_first = -1;
+  priv->virtual_list_n_shown = -1;
+}
+
+static gboolean
+filter_list_row (GtkListBoxRow *row,
+                 HdyComboRow   *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  guint position = gtk_list_box_row_get_index (row);
+  guint start = 0, end;
+
+  /* The rows of the virtual list are only created for the shown items. */
+  if (priv->filtered == NULL || priv->virtual_list)
+    return TRUE;
+
+  /* The filtered positions are sorted, so look it up by bisection. */
+  end = priv->filtered->len;
+  while (start < end) {
+    guint middle = start + (end - start) / 2;
+    guint middle_position = g_array_index (priv->filtered, guint, middle);
+
+    if (middle_position == position)
+      return TRUE;
+
+    if (middle_position < position)
+      start = middle + 1;
+    else
+      end = middle;
   }
+
+  return FALSE;
+}
+
+/* The item names are only computed and casefolded once, when first filtering,
+ * and the filtering itself doesn't need any row to exist.
+ */
+static void
+update_filter (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  g_autofree gchar *query = NULL;
+
+  g_clear_pointer (&priv->filtered, g_array_unref);
+
+  if (priv->bound_model == NULL)
+    return;
+
+  query = g_utf8_casefold (gtk_entry_get_text (GTK_ENTRY (priv->filter_entry)), -1);
+
+  if (priv->filter_enabled && *query != '\0') {
+    if (priv->name_keys == NULL) {
+      guint n_items = g_list_model_get_n_items (priv->bound_model);
+
+      priv->name_keys = g_ptr_array_new_full (n_items, g_free);
+
+      for (guint i = 0; i < n_items; i++) {
+        g_autoptr (GObject) item = g_list_model_get_item (priv->bound_model, i);
+        g_autofree gchar *name = get_item_name (self, item);
+
+        g_ptr_array_add (priv->name_keys, g_utf8_casefold (name != NULL ? name : "", -1));
+      }
+    }
+
+    priv->filtered = g_array_new (FALSE, FALSE, sizeof (guint));
+
+    for (guint i = 0; i < priv->name_keys->len; i++)
+      if (strstr (g_ptr_array_index (priv->name_keys, i), query) != NULL)
+        g_array_append_val (priv->filtered, i);
+  }
+
+  if (!priv->list_bound)
+    return;
+
+  if (priv->virtual_list) {
+    unbind_virtual_rows (self);
+    gtk_adjustment_set_value (gtk_scrolled_window_get_vadjustment (priv->scrolled_window), 0);
+    update_virtual_rows (self);
+  } else {
+    gtk_list_box_invalidate_filter (priv->list);
+  }
+}
+
+static void
+filter_entry_search_changed_cb (HdyComboRow *self)
+{
+  update_filter (self);
+}
+
+static void
+filter_entry_activate_cb (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  update_filter (self);
+
+  if (get_n_shown_items (self) == 0)
+    return;
+
+  hdy_combo_row_set_selected_index (self, get_shown_item_position (self, 0));
+  gtk_popover_popdown (priv->popover);
 }
 
 static void
@@ -231,11 +654,23 @@ bound_model_changed (GListModel *list,
   gint new_idx;
   HdyComboRow *self = HDY_COMBO_ROW (user_data);
   HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+  gboolean selected_removed;
+
+  /* The names and the filtered positions of the items must be updated. */
+  g_clear_pointer (&priv->name_keys, g_ptr_array_unref);
+  if (priv->filtered)
+    update_filter (self);
+  else if (priv->virtual_list && priv->list_bound) {
+    unbind_virtual_rows (self);
+    update_virtual_rows (self);
+  }
 
   /* Selection is in front of insertion/removal point, nothing to do */
-  if (priv->selected_index > 0 && priv->selected_index < index)
+  if (priv->selected_index >= 0 && priv->selected_index < index)
     return;
 
+  selected_removed = priv->selected_index >= 0 && priv->selected_index < index + removed;
+
   if (priv->selected_index < index + removed) {
     /* The item selected item was removed (or none is selected) */
     new_idx = -1;
@@ -248,14 +683,62 @@ bound_model_changed (GListModel *list,
   if (new_idx == -1 && g_list_model_get_n_items (list) > 0)
     new_idx = 0;
 
-  hdy_combo_row_set_selected_index (self, new_idx);
+  /* The selected item can be replaced while its index stays the same. */
+  if (new_idx == priv->selected_index && selected_removed)
+    update (self);
+  else
+    hdy_combo_row_set_selected_index (self, new_idx);
 }
 
 static void
 row_activated_cb (HdyComboRow   *self,
                   GtkListBoxRow *row)
 {
-  hdy_combo_row_set_selected_index (self, gtk_list_box_row_get_index (row));
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->virtual_list)
+    hdy_combo_row_set_selected_index (self, GPOINTER_TO_INT (g_object_get_data (G_OBJECT (row), "position")));
+  else
+    hdy_combo_row_set_selected_index (self, gtk_list_box_row_get_index (row));
+}
+
+/* The list is only populated the first time the popover is opened, as it would
+ * otherwise create a widget for every item of the model for nothing until then.
+ */
+static void
+ensure_list (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (priv->list_bound || priv->bound_model == NULL)
+    return;
+
+  priv->list_bound = TRUE;
+
+  if (priv->virtual_list)
+    update_virtual_rows (self);
+  else
+    gtk_list_box_bind_model (priv->list, priv->bound_model, create_list_widget, self, NULL);
+
+  update_checkmark (self);
+}
+
+static void
+clear_list (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  if (!priv->list_bound)
+    return;
+
+  set_selected_checkmark (self, NULL);
+
+  if (priv->virtual_list)
+    clear_virtual_rows (self);
+  else if (priv->list)
+    gtk_list_box_bind_model (priv->list, NULL, NULL, NULL, NULL);
+
+  priv->list_bound = FALSE;
 }
 
 static void
@@ -264,6 +747,14 @@ hdy_combo_row_activate (HdyActionRow *row)
   HdyComboRow *self = HDY_COMBO_ROW (row);
   HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
 
+  ensure_list (self);
+
+  if (priv->filter_enabled) {
+    gtk_entry_set_text (GTK_ENTRY (priv->filter_entry), "");
+    update_filter (self);
+    gtk_widget_grab_focus (GTK_WIDGET (priv->filter_entry));
+  }
+
   gtk_popover_popup (priv->popover);
 }
 
@@ -278,11 +769,16 @@ destroy_model (HdyComboRow *self)
   /* Disconnect the bound model *before* releasing it. */
   g_signal_handlers_disconnect_by_func (priv->bound_model, bound_model_changed, self);
 
+  set_current_item (self, NULL);
+  clear_list (self);
+  g_clear_pointer (&priv->name_keys, g_ptr_array_unref);
+  g_clear_pointer (&priv->filtered, g_array_unref);
+
   /* Destroy the model and the user data. */
-  if (priv->list)
-    gtk_list_box_bind_model (priv->list, NULL, NULL, NULL, NULL);
+  if (priv->create_widget_func_data_free_func)
+    priv->create_widget_func_data_free_func (priv->create_widget_func_data);
 
-  priv->bound_model = NULL;
+  g_clear_object (&priv->bound_model);
   priv->create_list_widget_func = NULL;
   priv->create_current_widget_func = NULL;
   priv->create_widget_func_data = NULL;
@@ -306,6 +802,12 @@ hdy_combo_row_get_property (GObject    *object,
   case PROP_USE_SUBTITLE:
     g_value_set_boolean (value, hdy_combo_row_get_use_subtitle (self));
     break;
+  case PROP_VIRTUAL_LIST:
+    g_value_set_boolean (value, hdy_combo_row_get_virtual_list (self));
+    break;
+  case PROP_FILTER_ENABLED:
+    g_value_set_boolean (value, hdy_combo_row_get_filter_enabled (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -326,6 +828,12 @@ hdy_combo_row_set_property (GObject      *object,
   case PROP_USE_SUBTITLE:
     hdy_combo_row_set_use_subtitle (self, g_value_get_boolean (value));
     break;
+  case PROP_VIRTUAL_LIST:
+    hdy_combo_row_set_virtual_list (self, g_value_get_boolean (value));
+    break;
+  case PROP_FILTER_ENABLED:
+    hdy_combo_row_set_filter_enabled (self, g_value_get_boolean (value));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -340,9 +848,30 @@ hdy_combo_row_dispose (GObject *object)
   destroy_model (self);
   g_clear_pointer (&priv->get_name, get_name_free);
 
+  /* Only one of the viewport and the layout is in the popover, the other one
+   * must be destroyed explicitly.
+   */
+  if (priv->viewport && gtk_widget_get_parent (priv->viewport) == NULL)
+    gtk_widget_destroy (priv->viewport);
+  if (priv->layout && gtk_widget_get_parent (priv->layout) == NULL)
+    gtk_widget_destroy (priv->layout);
+  g_clear_object (&priv->viewport);
+  g_clear_object (&priv->layout);
+
   G_OBJECT_CLASS (hdy_combo_row_parent_class)->dispose (object);
 }
 
+static void
+hdy_combo_row_finalize (GObject *object)
+{
+  HdyComboRow *self = HDY_COMBO_ROW (object);
+  HdyComboRowPrivate *priv = hdy_combo_row_get_instance_private (self);
+
+  g_ptr_array_unref (priv->virtual_rows);
+
+  G_OBJECT_CLASS (hdy_combo_row_parent_class)->finalize (object);
+}
+
 typedef struct {
   HdyComboRow *row;
   GtkCallback callback;
@@ -394,6 +923,7 @@ hdy_combo_row_class_init (HdyComboRowClass *klass)
   object_class->get_property = hdy_combo_row_get_property;
   object_class->set_property = hdy_combo_row_set_property;
   object_class->dispose = hdy_combo_row_dispose;
+  object_class->finalize = hdy_combo_row_finalize;
 
   container_class->forall = hdy_combo_row_forall;
 
@@ -432,6 +962,42 @@ hdy_combo_row_class_init (HdyComboRowClass *klass)
                           FALSE,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * HdyComboRow:virtual-list:
+   *
+   * Whether the popover list only creates rows for the visible items, and
+   * recycles them while scrolling.
+   *
+   * This makes models with thousands of items usable, but all the rows are
+   * assumed to have the same height.
+   *
+   * Since: 1.0
+   */
+  props[PROP_VIRTUAL_LIST] =
+    g_param_spec_boolean ("virtual-list",
+                          _("Virtual list"),
+                          _("Whether the popover list only creates rows for the visible items"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * HdyComboRow:filter-enabled:
+   *
+   * Whether the popover displays an entry to filter the items by name.
+   *
+   * The items are named by the closure given to
+   * hdy_combo_row_bind_name_model(), hdy_combo_row_set_for_enum() or
+   * hdy_combo_row_set_get_name_func(). Items without a name never match.
+   *
+   * Since: 1.0
+   */
+  props[PROP_FILTER_ENABLED] =
+    g_param_spec_boolean ("filter-enabled",
+                          _("Filter enabled"),
+                          _("Whether the popover displays an entry to filter the items by name"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   gtk_widget_class_set_template_from_resource (widget_class,
@@ -440,6 +1006,11 @@ hdy_combo_row_class_init (HdyComboRowClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, image);
   gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, list);
   gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, popover);
+  gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, filter_entry);
+  gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, scrolled_window);
+  gtk_widget_class_bind_template_child_private (widget_class, HdyComboRow, viewport);
+  gtk_widget_class_bind_template_callback (widget_class, filter_entry_activate_cb);
+  gtk_widget_class_bind_template_callback (widget_class, filter_entry_search_changed_cb);
 }
 
 static void
@@ -450,11 +1021,30 @@ hdy_combo_row_init (HdyComboRow *self)
   gtk_widget_init_template (GTK_WIDGET (self));
 
   priv->selected_index = -1;
+  priv->virtual_rows = g_ptr_array_new ();
+  priv->virtual_list_first = -1;
+  priv->virtual_list_n_shown = -1;
+
+  /* The viewport is kept alive when the list is moved to the virtual list's
+   * layout.
+   */
+  g_object_ref (priv->viewport);
+
+  gtk_list_box_set_filter_func (priv->list, (GtkListBoxFilterFunc) filter_list_row, self, NULL);
+
+  g_signal_connect_object (gtk_scrolled_window_get_vadjustment (priv->scrolled_window),
+                           "value-changed", G_CALLBACK (update_virtual_rows),
+                           self, G_CONNECT_SWAPPED);
+  g_signal_connect_object (gtk_scrolled_window_get_vadjustment (priv->scrolled_window),
+                           "changed", G_CALLBACK (update_virtual_rows),
+                           self, G_CONNECT_SWAPPED);
 
   g_signal_connect_object (priv->list, "row-activated", G_CALLBACK (gtk_widget_hide),
                            priv->popover, G_CONNECT_SWAPPED);
   g_signal_connect_object (priv->list, "row-activated", G_CALLBACK (row_activated_cb),
                            self, G_CONNECT_SWAPPED);
+  g_signal_connect_object (priv->list, "set-focus-child", G_CALLBACK (list_set_focus_child_cb),
+                           self, G_CONNECT_SWAPPED);
 
   update (self);
 }
@@ -539,7 +1129,6 @@ hdy_combo_row_bind_model (HdyComboRow                *self,
 
   destroy_model (self);
 
-  gtk_container_foreach (GTK_CONTAINER (priv->current), (GtkCallback) gtk_widget_destroy, NULL);
   priv->selected_index = -1;
 
   if (model == NULL) {
@@ -549,20 +1138,20 @@ hdy_combo_row_bind_model (HdyComboRow                *self,
     return;
   }
 
-  /* We don't need take a reference as the list box holds one for us. */
-  priv->bound_model = model;
+  priv->bound_model = g_object_ref (model);
   priv->create_list_widget_func = create_list_widget_func;
   priv->create_current_widget_func = create_current_widget_func;
   priv->create_widget_func_data = user_data;
   priv->create_widget_func_data_free_func = user_data_free_func;
 
-  g_signal_connect (priv->bound_model, "items-changed", G_CALLBACK (bound_model_changed), self);
+  /* Connect after the list box so its rows are up to date when the selection
+   * gets updated.
+   */
+  g_signal_connect_after (priv->bound_model, "items-changed", G_CALLBACK (bound_model_changed), self);
 
   if (g_list_model_get_n_items (priv->bound_model) > 0)
     priv->selected_index = 0;
 
-  gtk_list_box_bind_model (priv->list, model, create_list_widget, self, create_list_widget_data_free);
-
   gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (self), TRUE);
 
   update (self);
@@ -774,6 +1363,147 @@ hdy_combo_row_set_use_subtitle (HdyComboRow *self,
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_USE_SUBTITLE]);
 }
 
+/**
+ * hdy_combo_row_get_virtual_list:
+ * @self: a #HdyComboRow
+ *
+ * Gets whether the popover list of @self only creates rows for the visible
+ * items.
+ *
+ * Returns: whether the popover list of @self is virtual
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_combo_row_get_virtual_list (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_COMBO_ROW (self), FALSE);
+
+  priv = hdy_combo_row_get_instance_private (self);
+
+  return priv->virtual_list;
+}
+
+/**
+ * hdy_combo_row_set_virtual_list:
+ * @self: a #HdyComboRow
+ * @virtual_list: %TRUE to only create rows for the visible items
+ *
+ * Sets whether the popover list of @self only creates rows for the visible
+ * items, and recycles them while scrolling. See #HdyComboRow:virtual-list.
+ *
+ * Since: 1.0
+ */
+void
+hdy_combo_row_set_virtual_list (HdyComboRow *self,
+                                gboolean     virtual_list)
+{
+  HdyComboRowPrivate *priv;
+  GtkWidget *list;
+
+  g_return_if_fail (HDY_IS_COMBO_ROW (self));
+
+  priv = hdy_combo_row_get_instance_private (self);
+
+  virtual_list = !!virtual_list;
+
+  if (priv->virtual_list == virtual_list)
+    return;
+
+  clear_list (self);
+  priv->virtual_list = virtual_list;
+
+  list = g_object_ref (GTK_WIDGET (priv->list));
+  gtk_container_remove (GTK_CONTAINER (gtk_widget_get_parent (list)), list);
+
+  if (virtual_list) {
+    if (priv->layout == NULL) {
+      priv->layout = g_object_ref_sink (gtk_layout_new (NULL, NULL));
+      gtk_widget_show (priv->layout);
+    }
+
+    gtk_container_remove (GTK_CONTAINER (priv->scrolled_window), priv->viewport);
+    gtk_container_add (GTK_CONTAINER (priv->scrolled_window), priv->layout);
+    gtk_layout_put (GTK_LAYOUT (priv->layout), list, 0, 0);
+    /* The focused row is scrolled to by list_set_focus_child_cb(), the list
+     * box would pick the layout's adjustment up and scroll it to the wrong
+     * place otherwise. It picks the viewport's one up again when moved back.
+     */
+    gtk_list_box_set_adjustment (priv->list, NULL);
+    gtk_list_box_set_sort_func (priv->list, sort_virtual_rows, NULL, NULL);
+  } else {
+    gtk_list_box_set_sort_func (priv->list, NULL, NULL, NULL);
+    gtk_widget_set_size_request (list, -1, -1);
+    gtk_container_remove (GTK_CONTAINER (priv->scrolled_window), priv->layout);
+    gtk_container_add (GTK_CONTAINER (priv->scrolled_window), priv->viewport);
+    gtk_container_add (GTK_CONTAINER (priv->viewport), list);
+  }
+
+  g_object_unref (list);
+
+  if (gtk_widget_get_visible (GTK_WIDGET (priv->popover)))
+    ensure_list (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_VIRTUAL_LIST]);
+}
+
+/**
+ * hdy_combo_row_get_filter_enabled:
+ * @self: a #HdyComboRow
+ *
+ * Gets whether the popover of @self displays an entry to filter the items by
+ * name.
+ *
+ * Returns: whether filtering is enabled for @self
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_combo_row_get_filter_enabled (HdyComboRow *self)
+{
+  HdyComboRowPrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_COMBO_ROW (self), FALSE);
+
+  priv = hdy_combo_row_get_instance_private (self);
+
+  return priv->filter_enabled;
+}
+
+/**
+ * hdy_combo_row_set_filter_enabled:
+ * @self: a #HdyComboRow
+ * @filter_enabled: %TRUE to display an entry to filter the items
+ *
+ * Sets whether the popover of @self displays an entry to filter the items by
+ * name. See #HdyComboRow:filter-enabled.
+ *
+ * Since: 1.0
+ */
+void
+hdy_combo_row_set_filter_enabled (HdyComboRow *self,
+                                  gboolean     filter_enabled)
+{
+  HdyComboRowPrivate *priv;
+
+  g_return_if_fail (HDY_IS_COMBO_ROW (self));
+
+  priv = hdy_combo_row_get_instance_private (self);
+
+  filter_enabled = !!filter_enabled;
+
+  if (priv->filter_enabled == filter_enabled)
+    return;
+
+  priv->filter_enabled = filter_enabled;
+  gtk_widget_set_visible (GTK_WIDGET (priv->filter_entry), filter_enabled);
+  update_filter (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_FILTER_ENABLED]);
+}
+
 /**
  * hdy_combo_row_set_get_name_func:
  * @self: a #HdyComboRow
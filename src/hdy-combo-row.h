@@ -99,6 +99,18 @@ HDY_AVAILABLE_IN_ALL
 void     hdy_combo_row_set_use_subtitle (HdyComboRow *self,
                                          gboolean     use_subtitle);
 
+HDY_AVAILABLE_IN_ALL
+gboolean hdy_combo_row_get_virtual_list (HdyComboRow *self);
+HDY_AVAILABLE_IN_ALL
+void     hdy_combo_row_set_virtual_list (HdyComboRow *self,
+                                         gboolean     virtual_list);
+
+HDY_AVAILABLE_IN_ALL
+gboolean hdy_combo_row_get_filter_enabled (HdyComboRow *self);
+HDY_AVAILABLE_IN_ALL
+void     hdy_combo_row_set_filter_enabled (HdyComboRow *self,
+                                           gboolean     filter_enabled);
+
 HDY_AVAILABLE_IN_ALL
 void hdy_combo_row_set_get_name_func (HdyComboRow            *self,
                                       HdyComboRowGetNameFunc  get_name_func,
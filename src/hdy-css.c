@@ -8,41 +8,94 @@
 
 #include "hdy-css-private.h"
 
-void
-hdy_css_measure (GtkWidget      *widget,
-                 GtkOrientation  orientation,
-                 gint           *minimum,
-                 gint           *natural)
+/* The resolved box model of a style context. The border, the margin and the
+ * padding are only ever used summed together, so they are stored that way.
+ */
+typedef struct {
+  gboolean valid;
+  GtkStateFlags state_flags;
+  gint min_width;
+  gint min_height;
+  GtkBorder extents;
+} HdyCssBox;
+
+static void
+invalidate_box_cb (HdyCssBox *box)
 {
+  box->valid = FALSE;
+}
+
+/* Looking the properties up walks the CSS cascade, which is slow when done on
+ * every measure and allocation. The box model is instead cached on the style
+ * context, and invalidated when the context emits GtkStyleContext::changed or
+ * when the widget's state flags don't match the cached ones anymore.
+ */
+static HdyCssBox *
+get_box (GtkWidget *widget)
+{
+  static GQuark box_quark = 0;
   GtkStyleContext *style_context = gtk_widget_get_style_context (widget);
   GtkStateFlags state_flags = gtk_widget_get_state_flags (widget);
   GtkBorder border, margin, padding;
-  gint css_width, css_height;
+  HdyCssBox *box;
 
-  /* Manually apply minimum sizes, the border, the padding and the margin as we
-   * can't use the private GtkGagdet.
+  if (G_UNLIKELY (box_quark == 0))
+    box_quark = g_quark_from_static_string ("hdy-css-box");
+
+  box = g_object_get_qdata (G_OBJECT (style_context), box_quark);
+
+  /* The box is owned by the style context rather than by the widget, so it
+   * can't outlive the handler invalidating it.
    */
+  if (G_UNLIKELY (box == NULL)) {
+    box = g_new0 (HdyCssBox, 1);
+    g_object_set_qdata_full (G_OBJECT (style_context), box_quark, box, g_free);
+    g_signal_connect_swapped (style_context, "changed", G_CALLBACK (invalidate_box_cb), box);
+  }
+
+  if (box->valid && box->state_flags == state_flags)
+    return box;
+
   gtk_style_context_get (style_context, state_flags,
-                         "min-width", &css_width,
-                         "min-height", &css_height,
+                         "min-width", &box->min_width,
+                         "min-height", &box->min_height,
                          NULL);
   gtk_style_context_get_border (style_context, state_flags, &border);
   gtk_style_context_get_margin (style_context, state_flags, &margin);
   gtk_style_context_get_padding (style_context, state_flags, &padding);
+
+  box->extents.left = border.left + margin.left + padding.left;
+  box->extents.right = border.right + margin.right + padding.right;
+  box->extents.top = border.top + margin.top + padding.top;
+  box->extents.bottom = border.bottom + margin.bottom + padding.bottom;
+  box->state_flags = state_flags;
+  box->valid = TRUE;
+
+  return box;
+}
+
+void
+hdy_css_measure (GtkWidget      *widget,
+                 GtkOrientation  orientation,
+                 gint           *minimum,
+                 gint           *natural)
+{
+  HdyCssBox *box;
+
+  /* Manually apply minimum sizes, the border, the padding and the margin as we
+   * can't use the private GtkGagdet.
+   */
+  box = get_box (widget);
   if (orientation == GTK_ORIENTATION_VERTICAL) {
-    *minimum = MAX (*minimum, css_height) +
-               border.top + margin.top + padding.top +
-               border.bottom + margin.bottom + padding.bottom;
-    *natural = MAX (*natural, css_height) +
-               border.top + margin.top + padding.top +
-               border.bottom + margin.bottom + padding.bottom;
+    *minimum = MAX (*minimum, box->min_height) +
+               box->extents.top + box->extents.bottom;
+    *natural = MAX (*natural, box->min_height) +
+               box->extents.top + box->extents.bottom;
   } else {
-    *minimum = MAX (*minimum, css_width) +
-               border.left + margin.left + padding.left +
-               border.right + margin.right + padding.right;
-    *natural = MAX (*natural, css_width) +
-               border.left + margin.left + padding.left +
-               border.right + margin.right + padding.right;
+    *minimum = MAX (*minimum, box->min_width) +
+               box->extents.left + box->extents.right;
+    *natural = MAX (*natural, box->min_width) +
+               box->extents.left + box->extents.right;
   }
 }
 
@@ -50,24 +103,14 @@ void
 hdy_css_size_allocate (GtkWidget     *widget,
                        GtkAllocation *allocation)
 {
-  GtkStyleContext *style_context;
-  GtkStateFlags state_flags;
-  GtkBorder border, margin, padding;
+  HdyCssBox *box;
 
   /* Manually apply the border, the padding and the margin as we can't use the
    * private GtkGagdet.
    */
-  style_context = gtk_widget_get_style_context (widget);
-  state_flags = gtk_widget_get_state_flags (widget);
-  gtk_style_context_get_border (style_context, state_flags, &border);
-  gtk_style_context_get_margin (style_context, state_flags, &margin);
-  gtk_style_context_get_padding (style_context, state_flags, &padding);
-  allocation->width -= border.left + border.right +
-                       margin.left + margin.right +
-                       padding.left + padding.right;
-  allocation->height -= border.top + border.bottom +
-                        margin.top + margin.bottom +
-                        padding.top + padding.bottom;
-  allocation->x += border.left + margin.left + padding.left;
-  allocation->y += border.top + margin.top + padding.top;
+  box = get_box (widget);
+  allocation->width -= box->extents.left + box->extents.right;
+  allocation->height -= box->extents.top + box->extents.bottom;
+  allocation->x += box->extents.left;
+  allocation->y += box->extents.top;
 }
@@ -32,6 +32,13 @@
  * It contains the subnodes row.header for its main embedded row, list.nested
  * for the list it can expand, and image.expander-row-arrow for its arrow.
  *
+ * # Lazily created rows
+ *
+ * Nested rows can also be created from a #GListModel bound with
+ * hdy_expander_row_bind_model(). The rows are then only created the first time
+ * the row is expanded, and if #HdyExpanderRow:discard-on-collapse is %TRUE,
+ * they are destroyed again once the row is collapsed.
+ *
  * When expanded, #HdyExpanderRow will add the
  * .checked-expander-row-previous-sibling style class to its previous sibling,
  * and remove it when retracted.
@@ -45,6 +52,7 @@ typedef struct
   GtkBox *actions;
   GtkBox *prefixes;
   GtkListBox *list;
+  GtkRevealer *revealer;
   HdyActionRow *action_row;
   GtkSwitch *enable_switch;
   GtkImage *image;
@@ -52,6 +60,13 @@ typedef struct
   gboolean expanded;
   gboolean enable_expansion;
   gboolean show_enable_switch;
+
+  GListModel *bound_model;
+  GtkListBoxCreateWidgetFunc create_widget_func;
+  gpointer create_widget_func_data;
+  GDestroyNotify create_widget_func_data_free_func;
+  gboolean model_bound_to_list;
+  gboolean discard_on_collapse;
 } HdyExpanderRowPrivate;
 
 static void hdy_expander_row_buildable_init (GtkBuildableIface *iface);
@@ -71,6 +86,7 @@ enum {
   PROP_EXPANDED,
   PROP_ENABLE_EXPANSION,
   PROP_SHOW_ENABLE_SWITCH,
+  PROP_DISCARD_ON_COLLAPSE,
   LAST_PROP,
 };
 
@@ -135,6 +151,9 @@ hdy_expander_row_get_property (GObject    *object,
   case PROP_SHOW_ENABLE_SWITCH:
     g_value_set_boolean (value, hdy_expander_row_get_show_enable_switch (self));
     break;
+  case PROP_DISCARD_ON_COLLAPSE:
+    g_value_set_boolean (value, hdy_expander_row_get_discard_on_collapse (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -167,6 +186,9 @@ hdy_expander_row_set_property (GObject      *object,
   case PROP_SHOW_ENABLE_SWITCH:
     hdy_expander_row_set_show_enable_switch (self, g_value_get_boolean (value));
     break;
+  case PROP_DISCARD_ON_COLLAPSE:
+    hdy_expander_row_set_discard_on_collapse (self, g_value_get_boolean (value));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -218,7 +240,13 @@ list_children_changed_cb (HdyExpanderRow *self)
   GtkStyleContext *context = gtk_widget_get_style_context (GTK_WIDGET (self));
   gint count = 0;
 
-  gtk_container_foreach (GTK_CONTAINER (priv->list), (GtkCallback) count_children_cb, &count);
+  /* The rows of a bound model may not have been created yet, so count the
+   * items instead.
+   */
+  if (priv->bound_model)
+    count = g_list_model_get_n_items (priv->bound_model);
+  else
+    gtk_container_foreach (GTK_CONTAINER (priv->list), (GtkCallback) count_children_cb, &count);
 
   if (count == 0)
     gtk_style_context_add_class (context, "empty");
@@ -226,6 +254,77 @@ list_children_changed_cb (HdyExpanderRow *self)
     gtk_style_context_remove_class (context, "empty");
 }
 
+static void
+bind_model_to_list (HdyExpanderRow *self)
+{
+  HdyExpanderRowPrivate *priv = hdy_expander_row_get_instance_private (self);
+
+  if (priv->bound_model == NULL || priv->model_bound_to_list)
+    return;
+
+  /* The user data is owned by the row rather than by the list, as the model
+   * can be bound to the list and unbound from it several times.
+   */
+  gtk_list_box_bind_model (priv->list,
+                           priv->bound_model,
+                           priv->create_widget_func,
+                           priv->create_widget_func_data,
+                           NULL);
+  priv->model_bound_to_list = TRUE;
+}
+
+static void
+unbind_model_from_list (HdyExpanderRow *self)
+{
+  HdyExpanderRowPrivate *priv = hdy_expander_row_get_instance_private (self);
+
+  if (!priv->model_bound_to_list)
+    return;
+
+  /* This destroys the rows created for the model. */
+  gtk_list_box_bind_model (priv->list, NULL, NULL, NULL, NULL);
+  priv->model_bound_to_list = FALSE;
+}
+
+static void
+destroy_model (HdyExpanderRow *self)
+{
+  HdyExpanderRowPrivate *priv = hdy_expander_row_get_instance_private (self);
+
+  if (!priv->bound_model)
+    return;
+
+  /* Disconnect the bound model *before* releasing it. */
+  g_signal_handlers_disconnect_by_func (priv->bound_model, list_children_changed_cb, self);
+
+  unbind_model_from_list (self);
+
+  /* Destroy the model and the user data. */
+  if (priv->create_widget_func_data_free_func)
+    priv->create_widget_func_data_free_func (priv->create_widget_func_data);
+
+  g_clear_object (&priv->bound_model);
+  priv->create_widget_func = NULL;
+  priv->create_widget_func_data = NULL;
+  priv->create_widget_func_data_free_func = NULL;
+}
+
+static void
+child_revealed_cb (HdyExpanderRow *self)
+{
+  HdyExpanderRowPrivate *priv = hdy_expander_row_get_instance_private (self);
+
+  /* Wait for the end of the collapsing animation, so the rows don't disappear
+   * while they are still visible.
+   */
+  if (priv->expanded ||
+      !priv->discard_on_collapse ||
+      gtk_revealer_get_child_revealed (priv->revealer))
+    return;
+
+  unbind_model_from_list (self);
+}
+
 static void
 hdy_expander_row_add (GtkContainer *container,
                       GtkWidget    *child)
@@ -238,6 +337,8 @@ hdy_expander_row_add (GtkContainer *container,
    */
   if (priv->box == NULL)
     GTK_CONTAINER_CLASS (hdy_expander_row_parent_class)->add (container, child);
+  else if (priv->bound_model)
+    g_warning ("Cannot add children to a HdyExpanderRow bound to a model");
   else
     gtk_container_add (GTK_CONTAINER (priv->list), child);
 }
@@ -259,6 +360,16 @@ hdy_expander_row_remove (GtkContainer *container,
     gtk_container_remove (GTK_CONTAINER (priv->list), child);
 }
 
+static void
+hdy_expander_row_dispose (GObject *object)
+{
+  HdyExpanderRow *self = HDY_EXPANDER_ROW (object);
+
+  destroy_model (self);
+
+  G_OBJECT_CLASS (hdy_expander_row_parent_class)->dispose (object);
+}
+
 static void
 hdy_expander_row_class_init (HdyExpanderRowClass *klass)
 {
@@ -268,6 +379,7 @@ hdy_expander_row_class_init (HdyExpanderRowClass *klass)
 
   object_class->get_property = hdy_expander_row_get_property;
   object_class->set_property = hdy_expander_row_set_property;
+  object_class->dispose = hdy_expander_row_dispose;
 
   container_class->add = hdy_expander_row_add;
   container_class->remove = hdy_expander_row_remove;
@@ -352,6 +464,21 @@ hdy_expander_row_class_init (HdyExpanderRowClass *klass)
                           FALSE,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * HdyExpanderRow:discard-on-collapse:
+   *
+   * %TRUE if the rows created from the bound model are destroyed when the row
+   * is collapsed, see hdy_expander_row_bind_model().
+   *
+   * Since: 1.0
+   */
+  props[PROP_DISCARD_ON_COLLAPSE] =
+    g_param_spec_boolean ("discard-on-collapse",
+                          _("Discard on collapse"),
+                          _("Whether the rows created from the bound model are destroyed when the row is collapsed"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   gtk_widget_class_set_template_from_resource (widget_class,
@@ -360,9 +487,11 @@ hdy_expander_row_class_init (HdyExpanderRowClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, box);
   gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, actions);
   gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, list);
+  gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, revealer);
   gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, image);
   gtk_widget_class_bind_template_child_private (widget_class, HdyExpanderRow, enable_switch);
   gtk_widget_class_bind_template_callback (widget_class, activate_cb);
+  gtk_widget_class_bind_template_callback (widget_class, child_revealed_cb);
   gtk_widget_class_bind_template_callback (widget_class, list_children_changed_cb);
 }
 
@@ -598,6 +727,10 @@ hdy_expander_row_set_expanded (HdyExpanderRow *self,
 
   priv->expanded = expanded;
 
+  /* Create the rows of the bound model before they get revealed. */
+  if (priv->expanded)
+    bind_model_to_list (self);
+
   update_arrow (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_EXPANDED]);
@@ -760,3 +893,123 @@ hdy_expander_row_add_prefix (HdyExpanderRow *self,
   gtk_box_pack_start (priv->prefixes, widget, FALSE, TRUE, 0);
   gtk_widget_show (GTK_WIDGET (priv->prefixes));
 }
+
+/**
+ * hdy_expander_row_bind_model:
+ * @self: a #HdyExpanderRow
+ * @model: (nullable): the #GListModel to be bound to @self
+ * @create_widget_func: (nullable) (scope call): a function that creates
+ *   widgets for items, or %NULL in case you also passed %NULL as @model
+ * @user_data: user data passed to @create_widget_func
+ * @user_data_free_func: function for freeing @user_data
+ *
+ * Binds @model to @self.
+ *
+ * If @self was already bound to a model, that previous binding is destroyed.
+ *
+ * The nested rows of @self are cleared, and widgets representing the items of
+ * @model are created with @create_widget_func the first time @self is
+ * expanded, or immediately if it is already expanded. The nested rows are then
+ * updated whenever @model changes. If @model is %NULL, @self is left empty.
+ *
+ * Widgets can't be added to @self with gtk_container_add() while a model is
+ * bound.
+ *
+ * Since: 1.0
+ */
+void
+hdy_expander_row_bind_model (HdyExpanderRow             *self,
+                             GListModel                 *model,
+                             GtkListBoxCreateWidgetFunc  create_widget_func,
+                             gpointer                    user_data,
+                             GDestroyNotify              user_data_free_func)
+{
+  HdyExpanderRowPrivate *priv;
+
+  g_return_if_fail (HDY_IS_EXPANDER_ROW (self));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_widget_func != NULL);
+
+  priv = hdy_expander_row_get_instance_private (self);
+
+  destroy_model (self);
+
+  /* Binding a model to the list clears it, do it now too for consistency. */
+  gtk_container_foreach (GTK_CONTAINER (priv->list), (GtkCallback) gtk_widget_destroy, NULL);
+
+  if (model == NULL) {
+    list_children_changed_cb (self);
+
+    return;
+  }
+
+  priv->bound_model = g_object_ref (model);
+  priv->create_widget_func = create_widget_func;
+  priv->create_widget_func_data = user_data;
+  priv->create_widget_func_data_free_func = user_data_free_func;
+
+  g_signal_connect_swapped (priv->bound_model, "items-changed", G_CALLBACK (list_children_changed_cb), self);
+
+  if (priv->expanded)
+    bind_model_to_list (self);
+
+  list_children_changed_cb (self);
+}
+
+/**
+ * hdy_expander_row_get_discard_on_collapse:
+ * @self: a #HdyExpanderRow
+ *
+ * Gets whether the rows created from the model bound to @self are destroyed
+ * when @self is collapsed.
+ *
+ * Returns: whether the rows are destroyed when @self is collapsed
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_expander_row_get_discard_on_collapse (HdyExpanderRow *self)
+{
+  HdyExpanderRowPrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_EXPANDER_ROW (self), FALSE);
+
+  priv = hdy_expander_row_get_instance_private (self);
+
+  return priv->discard_on_collapse;
+}
+
+/**
+ * hdy_expander_row_set_discard_on_collapse:
+ * @self: a #HdyExpanderRow
+ * @discard_on_collapse: %TRUE to destroy the rows when @self is collapsed
+ *
+ * Sets whether the rows created from the model bound to @self are destroyed
+ * once @self is collapsed, to save memory. They are created again the next
+ * time @self is expanded.
+ *
+ * This has no effect on rows added with gtk_container_add().
+ *
+ * Since: 1.0
+ */
+void
+hdy_expander_row_set_discard_on_collapse (HdyExpanderRow *self,
+                                          gboolean        discard_on_collapse)
+{
+  HdyExpanderRowPrivate *priv;
+
+  g_return_if_fail (HDY_IS_EXPANDER_ROW (self));
+
+  priv = hdy_expander_row_get_instance_private (self);
+
+  discard_on_collapse = !!discard_on_collapse;
+
+  if (priv->discard_on_collapse == discard_on_collapse)
+    return;
+
+  priv->discard_on_collapse = discard_on_collapse;
+
+  child_revealed_cb (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DISCARD_ON_COLLAPSE]);
+}
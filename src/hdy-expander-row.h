@@ -73,6 +73,19 @@ HDY_AVAILABLE_IN_ALL
 void     hdy_expander_row_set_show_enable_switch (HdyExpanderRow *self,
                                                   gboolean        show_enable_switch);
 
+HDY_AVAILABLE_IN_ALL
+gboolean hdy_expander_row_get_discard_on_collapse (HdyExpanderRow *self);
+HDY_AVAILABLE_IN_ALL
+void     hdy_expander_row_set_discard_on_collapse (HdyExpanderRow *self,
+                                                   gboolean        discard_on_collapse);
+
+HDY_AVAILABLE_IN_ALL
+void     hdy_expander_row_bind_model (HdyExpanderRow             *self,
+                                      GListModel                 *model,
+                                      GtkListBoxCreateWidgetFunc  create_widget_func,
+                                      gpointer                    user_data,
+                                      GDestroyNotify              user_data_free_func);
+
 HDY_AVAILABLE_IN_ALL
 void     hdy_expander_row_add_action (HdyExpanderRow *self,
                                       GtkWidget      *widget);
@@ -72,6 +72,16 @@
 #define MOBILE_WINDOW_WIDTH  480
 #define MOBILE_WINDOW_HEIGHT 800
 
+typedef enum {
+  TITLEBUTTON_ICON,
+  TITLEBUTTON_MENU,
+  TITLEBUTTON_MINIMIZE,
+  TITLEBUTTON_MAXIMIZE,
+  TITLEBUTTON_CLOSE,
+  TITLEBUTTON_BACK,
+  N_TITLEBUTTON_TYPES,
+} TitlebuttonType;
+
 typedef struct {
   gchar *title;
   gchar *subtitle;
@@ -86,6 +96,16 @@ typedef struct {
 
   GList *children;
 
+  /* The visible children and their widths for the height they were last
+   * measured for, cached for the duration of a layout cycle.
+   */
+  GPtrArray *visible_children;
+  gint n_visible_children[2];
+  gboolean visible_children_valid;
+  GArray *visible_sizes;
+  gint visible_sizes_for_height;
+  gboolean visible_sizes_valid;
+
   gboolean shows_wm_decorations;
   gchar *decoration_layout;
   gboolean decoration_layout_set;
@@ -98,6 +118,15 @@ typedef struct {
 
   GtkWidget *titlebar_icon;
 
+  /* The window buttons of the start and end boxes, indexed by type. */
+  GtkWidget *titlebar_buttons[2][N_TITLEBUTTON_TYPES];
+  /* Whether the existing window buttons must fetch the window icon again. */
+  gboolean window_icon_changed;
+
+  /* The last parsed decoration layout and its tokens for each side. */
+  gchar *titlebar_layout;
+  gchar **titlebar_layout_tokens[2];
+
   guint tick_id;
   GtkProgressTracker tracker;
   gboolean first_frame_skipped;
@@ -367,6 +396,400 @@ _hdy_header_bar_update_separator_visibility (HdyHeaderBar *self)
     gtk_widget_set_visible (priv->titlebar_end_separator, have_visible_at_end);
 }
 
+static GtkWindow *
+get_window (HdyHeaderBar *self)
+{
+  GtkWidget *toplevel = gtk_widget_get_toplevel (GTK_WIDGET (self));
+
+  return GTK_IS_WINDOW (toplevel) ? GTK_WINDOW (toplevel) : NULL;
+}
+
+static void
+minimize_clicked_cb (HdyHeaderBar *self)
+{
+  GtkWindow *window = get_window (self);
+
+  if (window)
+    gtk_window_iconify (window);
+}
+
+static void
+maximize_clicked_cb (HdyHeaderBar *self)
+{
+  GtkWindow *window = get_window (self);
+
+  if (window)
+    hdy_gtk_window_toggle_maximized (window);
+}
+
+static void
+close_clicked_cb (HdyHeaderBar *self)
+{
+  GtkWindow *window = get_window (self);
+
+  if (window)
+    gtk_window_close (window);
+}
+
+static void
+set_accessible_name (GtkWidget   *widget,
+                     const gchar *name)
+{
+  AtkObject *accessible = gtk_widget_get_accessible (widget);
+
+  if (GTK_IS_ACCESSIBLE (accessible))
+    atk_object_set_name (accessible, name);
+}
+
+static GtkWidget *
+create_titlebutton_with_icon (const gchar *style_class,
+                              const gchar *icon_name)
+{
+  GtkWidget *button = gtk_button_new ();
+  GtkWidget *image = gtk_image_new_from_icon_name (icon_name, GTK_ICON_SIZE_MENU);
+
+  gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
+  gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
+  gtk_style_context_add_class (gtk_widget_get_style_context (button), style_class);
+  g_object_set (image, "use-fallback", TRUE, NULL);
+  gtk_container_add (GTK_CONTAINER (button), image);
+  gtk_widget_set_can_focus (button, FALSE);
+  gtk_widget_show_all (button);
+
+  return button;
+}
+
+/* Creates the parts of a window button that don't depend on the state of the
+ * window, update_titlebutton() takes care of the rest.
+ */
+static GtkWidget *
+create_titlebutton (HdyHeaderBar    *self,
+                    TitlebuttonType  type)
+{
+  GtkWidget *button = NULL;
+  GtkWidget *image;
+
+  switch (type) {
+  case TITLEBUTTON_ICON:
+    button = gtk_image_new ();
+    gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
+    gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
+    gtk_style_context_add_class (gtk_widget_get_style_context (button), "icon");
+    gtk_widget_set_size_request (button, 20, 20);
+    gtk_widget_show (button);
+    break;
+  case TITLEBUTTON_MENU:
+    button = gtk_menu_button_new ();
+    gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
+    gtk_menu_button_set_use_popover (GTK_MENU_BUTTON (button), TRUE);
+    gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
+    gtk_style_context_add_class (gtk_widget_get_style_context (button), "appmenu");
+    image = gtk_image_new ();
+    gtk_container_add (GTK_CONTAINER (button), image);
+    gtk_widget_set_can_focus (button, FALSE);
+    gtk_widget_show_all (button);
+    set_accessible_name (button, _("Application menu"));
+    break;
+  case TITLEBUTTON_MINIMIZE:
+    button = create_titlebutton_with_icon ("minimize", "window-minimize-symbolic");
+    g_signal_connect_swapped (button, "clicked",
+                              G_CALLBACK (minimize_clicked_cb), self);
+    set_accessible_name (button, _("Minimize"));
+    break;
+  case TITLEBUTTON_MAXIMIZE:
+    /* The icon and the accessible name depend on the window state. */
+    button = create_titlebutton_with_icon ("maximize", NULL);
+    g_signal_connect_swapped (button, "clicked",
+                              G_CALLBACK (maximize_clicked_cb), self);
+    break;
+  case TITLEBUTTON_CLOSE:
+    button = create_titlebutton_with_icon ("close", "window-close-symbolic");
+    g_signal_connect_swapped (button, "clicked",
+                              G_CALLBACK (close_clicked_cb), self);
+    set_accessible_name (button, _("Close"));
+    break;
+  case TITLEBUTTON_BACK:
+    button = gtk_button_new ();
+    gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
+    image = gtk_image_new_from_icon_name ("go-previous-symbolic", GTK_ICON_SIZE_BUTTON);
+    g_object_set (image, "use-fallback", TRUE, NULL);
+    gtk_container_add (GTK_CONTAINER (button), image);
+    gtk_widget_set_can_focus (button, TRUE);
+    gtk_widget_show_all (button);
+    g_signal_connect_swapped (button, "clicked",
+                              G_CALLBACK (close_clicked_cb), self);
+    set_accessible_name (button, _("Back"));
+    break;
+  case N_TITLEBUTTON_TYPES:
+  default:
+    g_assert_not_reached ();
+  }
+
+  return button;
+}
+
+/* Updates the parts of a window button depending on the state of the window,
+ * returns %FALSE if the button can't be shown.
+ */
+static gboolean
+update_titlebutton (HdyHeaderBar    *self,
+                    TitlebuttonType  type,
+                    GtkWidget       *button,
+                    gboolean         is_new,
+                    GtkWindow       *window,
+                    GMenuModel      *menu)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+  GtkWidget *image;
+
+  switch (type) {
+  case TITLEBUTTON_ICON:
+    priv->titlebar_icon = button;
+
+    /* The window icon is only fetched again when it or the window changes. */
+    if ((is_new || priv->window_icon_changed) &&
+        !hdy_header_bar_update_window_icon (self, window)) {
+      priv->titlebar_icon = NULL;
+
+      return FALSE;
+    }
+    break;
+  case TITLEBUTTON_MENU:
+    image = gtk_bin_get_child (GTK_BIN (button));
+    priv->titlebar_icon = image;
+
+    if (gtk_menu_button_get_menu_model (GTK_MENU_BUTTON (button)) != menu)
+      gtk_menu_button_set_menu_model (GTK_MENU_BUTTON (button), menu);
+
+    if ((is_new || priv->window_icon_changed) &&
+        !hdy_header_bar_update_window_icon (self, window))
+      gtk_image_set_from_icon_name (GTK_IMAGE (image),
+                                    "application-x-executable-symbolic", GTK_ICON_SIZE_MENU);
+    break;
+  case TITLEBUTTON_MAXIMIZE:
+    {
+      gboolean maximized = gtk_window_is_maximized (window);
+      const gchar *icon_name = maximized ? "window-restore-symbolic" : "window-maximize-symbolic";
+      const gchar *current_icon_name = NULL;
+
+      image = gtk_bin_get_child (GTK_BIN (button));
+      gtk_image_get_icon_name (GTK_IMAGE (image), &current_icon_name, NULL);
+
+      if (g_strcmp0 (current_icon_name, icon_name) != 0) {
+        gtk_image_set_from_icon_name (GTK_IMAGE (image), icon_name, GTK_ICON_SIZE_MENU);
+        set_accessible_name (button, maximized ? _("Restore") : _("Maximize"));
+      }
+    }
+    break;
+  case TITLEBUTTON_MINIMIZE:
+  case TITLEBUTTON_CLOSE:
+  case TITLEBUTTON_BACK:
+    break;
+  case N_TITLEBUTTON_TYPES:
+  default:
+    g_assert_not_reached ();
+  }
+
+  return TRUE;
+}
+
+static TitlebuttonType
+get_titlebutton_type (const gchar *token,
+                      gint         side,
+                      GtkWindow   *window,
+                      GMenuModel  *menu,
+                      gboolean     is_sovereign_window,
+                      gboolean     is_mobile_dialog)
+{
+  if (strcmp (token, "icon") == 0 &&
+      is_sovereign_window)
+    return TITLEBUTTON_ICON;
+
+  if (strcmp (token, "menu") == 0 &&
+      menu != NULL &&
+      is_sovereign_window)
+    return TITLEBUTTON_MENU;
+
+  if (strcmp (token, "minimize") == 0 &&
+      is_sovereign_window)
+    return TITLEBUTTON_MINIMIZE;
+
+  if (strcmp (token, "maximize") == 0 &&
+      gtk_window_get_resizable (window) &&
+      is_sovereign_window)
+    return TITLEBUTTON_MAXIMIZE;
+
+  if (strcmp (token, "close") == 0 &&
+      gtk_window_get_deletable (window) &&
+      !is_mobile_dialog)
+    return TITLEBUTTON_CLOSE;
+
+  if (side == 0 && /* Only at the start. */
+      gtk_window_get_deletable (window) &&
+      is_mobile_dialog)
+    return TITLEBUTTON_BACK;
+
+  return N_TITLEBUTTON_TYPES;
+}
+
+static void
+clear_titlebar_box (HdyHeaderBar *self,
+                    gint          side)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+  GtkWidget **box = side == 0 ? &priv->titlebar_start_box : &priv->titlebar_end_box;
+  GtkWidget **separator = side == 0 ? &priv->titlebar_start_separator : &priv->titlebar_end_separator;
+  gint i;
+
+  if (*box == NULL)
+    return;
+
+  gtk_widget_unparent (*box);
+  *box = NULL;
+  *separator = NULL;
+
+  for (i = 0; i < N_TITLEBUTTON_TYPES; i++)
+    priv->titlebar_buttons[side][i] = NULL;
+}
+
+/* Parses the decoration layout only when it changed. */
+static void
+update_titlebar_layout (HdyHeaderBar *self,
+                        const gchar  *layout_desc)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+  g_auto(GStrv) tokens = NULL;
+  gint i;
+
+  if (layout_desc == NULL)
+    layout_desc = "";
+
+  if (!g_strcmp0 (priv->titlebar_layout, layout_desc))
+    return;
+
+  g_free (priv->titlebar_layout);
+  priv->titlebar_layout = g_strdup (layout_desc);
+
+  for (i = 0; i < 2; i++)
+    g_clear_pointer (&priv->titlebar_layout_tokens[i], g_strfreev);
+
+  tokens = g_strsplit (layout_desc, ":", 2);
+  for (i = 0; i < 2 && tokens[i] != NULL; i++)
+    priv->titlebar_layout_tokens[i] = g_strsplit (tokens[i], ",", -1);
+}
+
+/* Reconciles the window buttons of one side with the layout, reusing the
+ * existing buttons and only creating or destroying the ones which appeared or
+ * disappeared.
+ */
+static void
+update_titlebar_box (HdyHeaderBar     *self,
+                     gint              side,
+                     GtkWindow        *window,
+                     GMenuModel       *menu,
+                     gboolean          is_sovereign_window,
+                     gboolean          is_mobile_dialog,
+                     GtkTextDirection  direction)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+  GtkWidget **box = side == 0 ? &priv->titlebar_start_box : &priv->titlebar_end_box;
+  GtkWidget **separator = side == 0 ? &priv->titlebar_start_separator : &priv->titlebar_end_separator;
+  GtkWidget **buttons = priv->titlebar_buttons[side];
+  gchar **t = priv->titlebar_layout_tokens[side];
+  gboolean wanted[N_TITLEBUTTON_TYPES] = { FALSE, };
+  TitlebuttonType order[N_TITLEBUTTON_TYPES];
+  GtkStyleContext *context;
+  gint n_buttons = 0, first_position, position, i;
+
+  for (i = 0; t && t[i]; i++) {
+    TitlebuttonType type = get_titlebutton_type (t[i], side, window, menu,
+                                                 is_sovereign_window,
+                                                 is_mobile_dialog);
+
+    if (type == N_TITLEBUTTON_TYPES || wanted[type])
+      continue;
+
+    wanted[type] = TRUE;
+    order[n_buttons++] = type;
+  }
+
+  if (n_buttons == 0) {
+    clear_titlebar_box (self, side);
+
+    return;
+  }
+
+  for (i = 0; i < N_TITLEBUTTON_TYPES; i++) {
+    if (wanted[i] || buttons[i] == NULL)
+      continue;
+
+    gtk_widget_destroy (buttons[i]);
+    buttons[i] = NULL;
+  }
+
+  if (*box == NULL) {
+    *separator = gtk_separator_new (GTK_ORIENTATION_VERTICAL);
+    gtk_widget_set_no_show_all (*separator, TRUE);
+    gtk_style_context_add_class (gtk_widget_get_style_context (*separator), "titlebutton");
+
+    *box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, priv->spacing);
+    gtk_box_pack_start (GTK_BOX (*box), *separator, FALSE, FALSE, 0);
+    gtk_widget_show (*box);
+    gtk_widget_set_parent (*box, GTK_WIDGET (self));
+  } else {
+    gtk_box_set_spacing (GTK_BOX (*box), priv->spacing);
+  }
+
+  /* The separator goes after the start buttons and before the end ones. */
+  first_position = side == 0 ? 0 : 1;
+  position = first_position;
+
+  for (i = 0; i < n_buttons; i++) {
+    TitlebuttonType type = order[i];
+    gboolean is_new = buttons[type] == NULL;
+    gint current_position;
+
+    if (is_new) {
+      buttons[type] = create_titlebutton (self, type);
+      gtk_box_pack_start (GTK_BOX (*box), buttons[type], FALSE, FALSE, 0);
+    }
+
+    if (!update_titlebutton (self, type, buttons[type], is_new, window, menu)) {
+      gtk_widget_destroy (buttons[type]);
+      buttons[type] = NULL;
+
+      continue;
+    }
+
+    gtk_container_child_get (GTK_CONTAINER (*box), buttons[type],
+                             "position", &current_position,
+                             NULL);
+    if (current_position != position)
+      gtk_box_reorder_child (GTK_BOX (*box), buttons[type], position);
+
+    position++;
+  }
+
+  if (position == first_position) {
+    clear_titlebar_box (self, side);
+
+    return;
+  }
+
+  if (side == 1)
+    gtk_box_reorder_child (GTK_BOX (*box), *separator, 0);
+
+  context = gtk_widget_get_style_context (*box);
+  if ((direction == GTK_TEXT_DIR_LTR && side == 0) ||
+      (direction == GTK_TEXT_DIR_RTL && side == 1)) {
+    gtk_style_context_remove_class (context, GTK_STYLE_CLASS_RIGHT);
+    gtk_style_context_add_class (context, GTK_STYLE_CLASS_LEFT);
+  } else {
+    gtk_style_context_remove_class (context, GTK_STYLE_CLASS_LEFT);
+    gtk_style_context_add_class (context, GTK_STYLE_CLASS_RIGHT);
+  }
+}
+
 static void
 hdy_header_bar_update_window_buttons (HdyHeaderBar *self)
 {
@@ -375,8 +798,7 @@ hdy_header_bar_update_window_buttons (HdyHeaderBar *self)
   GtkWindow *window;
   GtkTextDirection direction;
   gchar *layout_desc;
-  gchar **tokens, **t;
-  gint i, j;
+  gint i;
   GMenuModel *menu;
   gboolean shown_by_shell;
   gboolean is_sovereign_window;
@@ -386,21 +808,14 @@ hdy_header_bar_update_window_buttons (HdyHeaderBar *self)
   if (!gtk_widget_is_toplevel (toplevel))
     return;
 
-  if (priv->titlebar_start_box) {
-    gtk_widget_unparent (priv->titlebar_start_box);
-    priv->titlebar_start_box = NULL;
-    priv->titlebar_start_separator = NULL;
-  }
-  if (priv->titlebar_end_box) {
-    gtk_widget_unparent (priv->titlebar_end_box);
-    priv->titlebar_end_box = NULL;
-    priv->titlebar_end_separator = NULL;
-  }
-
   priv->titlebar_icon = NULL;
 
-  if (!priv->shows_wm_decorations)
+  if (!priv->shows_wm_decorations) {
+    clear_titlebar_box (self, 0);
+    clear_titlebar_box (self, 1);
+
     return;
+  }
 
   direction = gtk_widget_get_direction (widget);
 
@@ -409,10 +824,12 @@ hdy_header_bar_update_window_buttons (HdyHeaderBar *self)
                 "gtk-decoration-layout", &layout_desc,
                 NULL);
 
-  if (priv->decoration_layout_set) {
-    g_free (layout_desc);
-    layout_desc = g_strdup (priv->decoration_layout);
-  }
+  if (priv->decoration_layout_set)
+    update_titlebar_layout (self, priv->decoration_layout);
+  else
+    update_titlebar_layout (self, layout_desc);
+
+  g_free (layout_desc);
 
   window = GTK_WINDOW (toplevel);
 
@@ -427,183 +844,23 @@ hdy_header_bar_update_window_buttons (HdyHeaderBar *self)
 
   is_mobile_dialog= (priv->is_mobile_window && !is_sovereign_window);
 
-  tokens = g_strsplit (layout_desc, ":", 2);
-  if (tokens)   {
-    for (i = 0; i < 2; i++) {
-      GtkWidget *box;
-      GtkWidget *separator;
-      int n_children = 0;
-
-      if (tokens[i] == NULL)
-        break;
-
-      t = g_strsplit (tokens[i], ",", -1);
-
-      separator = gtk_separator_new (GTK_ORIENTATION_VERTICAL);
-      gtk_widget_set_no_show_all (separator, TRUE);
-      gtk_style_context_add_class (gtk_widget_get_style_context (separator), "titlebutton");
-
-      box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, priv->spacing);
-
-      for (j = 0; t[j]; j++) {
-        GtkWidget *button = NULL;
-        GtkWidget *image = NULL;
-        AtkObject *accessible;
-
-        if (strcmp (t[j], "icon") == 0 &&
-            is_sovereign_window) {
-            button = gtk_image_new ();
-            gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-            priv->titlebar_icon = button;
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "icon");
-            gtk_widget_set_size_request (button, 20, 20);
-            gtk_widget_show (button);
-
-            if (!hdy_header_bar_update_window_icon (self, window))
-              {
-                gtk_widget_destroy (button);
-                priv->titlebar_icon = NULL;
-                button = NULL;
-              }
-        } else if (strcmp (t[j], "menu") == 0 &&
-                 menu != NULL &&
-                 is_sovereign_window) {
-            button = gtk_menu_button_new ();
-            gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-            gtk_menu_button_set_menu_model (GTK_MENU_BUTTON (button), menu);
-            gtk_menu_button_set_use_popover (GTK_MENU_BUTTON (button), TRUE);
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "appmenu");
-            image = gtk_image_new ();
-            gtk_container_add (GTK_CONTAINER (button), image);
-            gtk_widget_set_can_focus (button, FALSE);
-            gtk_widget_show_all (button);
-
-            accessible = gtk_widget_get_accessible (button);
-            if (GTK_IS_ACCESSIBLE (accessible))
-              atk_object_set_name (accessible, _("Application menu"));
-
-            priv->titlebar_icon = image;
-            if (!hdy_header_bar_update_window_icon (self, window))
-              gtk_image_set_from_icon_name (GTK_IMAGE (priv->titlebar_icon),
-                                            "application-x-executable-symbolic", GTK_ICON_SIZE_MENU);
-        } else if (strcmp (t[j], "minimize") == 0 &&
-                 is_sovereign_window) {
-            button = gtk_button_new ();
-            gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "minimize");
-            image = gtk_image_new_from_icon_name ("window-minimize-symbolic", GTK_ICON_SIZE_MENU);
-            g_object_set (image, "use-fallback", TRUE, NULL);
-            gtk_container_add (GTK_CONTAINER (button), image);
-            gtk_widget_set_can_focus (button, FALSE);
-            gtk_widget_show_all (button);
-            g_signal_connect_swapped (button, "clicked",
-                                      G_CALLBACK (gtk_window_iconify), window);
-
-            accessible = gtk_widget_get_accessible (button);
-            if (GTK_IS_ACCESSIBLE (accessible))
-              atk_object_set_name (accessible, _("Minimize"));
-        } else if (strcmp (t[j], "maximize") == 0 &&
-                 gtk_window_get_resizable (window) &&
-                 is_sovereign_window) {
-            const gchar *icon_name;
-            gboolean maximized = gtk_window_is_maximized (window);
-
-            icon_name = maximized ? "window-restore-symbolic" : "window-maximize-symbolic";
-            button = gtk_button_new ();
-            gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
-            gtk_style_context_add_class (gtk_widget_get_style_context (button), "maximize");
-            image = gtk_image_new_from_icon_name (icon_name, GTK_ICON_SIZE_MENU);
-            g_object_set (image, "use-fallback", TRUE, NULL);
-            gtk_container_add (GTK_CONTAINER (button), image);
-            gtk_widget_set_can_focus (button, FALSE);
-            gtk_widget_show_all (button);
-            g_signal_connect_swapped (button, "clicked",
-                                      G_CALLBACK (hdy_gtk_window_toggle_maximized), window);
-
-            accessible = gtk_widget_get_accessible (button);
-            if (GTK_IS_ACCESSIBLE (accessible))
-              atk_object_set_name (accessible, maximized ? _("Restore") : _("Maximize"));
-        } else if (strcmp (t[j], "close") == 0 &&
-                   gtk_window_get_deletable (window) &&
-                   !is_mobile_dialog) {
-          button = gtk_button_new ();
-          gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-          image = gtk_image_new_from_icon_name ("window-close-symbolic", GTK_ICON_SIZE_MENU);
-          gtk_style_context_add_class (gtk_widget_get_style_context (button), "titlebutton");
-          gtk_style_context_add_class (gtk_widget_get_style_context (button), "close");
-          g_object_set (image, "use-fallback", TRUE, NULL);
-          gtk_container_add (GTK_CONTAINER (button), image);
-          gtk_widget_set_can_focus (button, FALSE);
-          gtk_widget_show_all (button);
-          g_signal_connect_swapped (button, "clicked",
-                                    G_CALLBACK (gtk_window_close), window);
-
-          accessible = gtk_widget_get_accessible (button);
-          if (GTK_IS_ACCESSIBLE (accessible))
-            atk_object_set_name (accessible, _("Close"));
-        } else if (i == 0 && /* Only at the start. */
-                   gtk_window_get_deletable (window) &&
-                   is_mobile_dialog) {
-          button = gtk_button_new ();
-          gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
-          image = gtk_image_new_from_icon_name ("go-previous-symbolic", GTK_ICON_SIZE_BUTTON);
-          g_object_set (image, "use-fallback", TRUE, NULL);
-          gtk_container_add (GTK_CONTAINER (button), image);
-          gtk_widget_set_can_focus (button, TRUE);
-          gtk_widget_show_all (button);
-          g_signal_connect_swapped (button, "clicked",
-                                    G_CALLBACK (gtk_window_close), window);
-
-          accessible = gtk_widget_get_accessible (button);
-          if (GTK_IS_ACCESSIBLE (accessible))
-            atk_object_set_name (accessible, _("Back"));
-        }
+  for (i = 0; i < 2; i++)
+    update_titlebar_box (self, i, window, menu,
+                         is_sovereign_window, is_mobile_dialog, direction);
 
-        if (button) {
-          gtk_box_pack_start (GTK_BOX (box), button, FALSE, FALSE, 0);
-          n_children ++;
-        }
-      }
-      g_strfreev (t);
+  priv->window_icon_changed = FALSE;
 
-      if (n_children == 0) {
-        g_object_ref_sink (box);
-        g_object_unref (box);
-        g_object_ref_sink (separator);
-        g_object_unref (separator);
-        continue;
-      }
-
-      gtk_box_pack_start (GTK_BOX (box), separator, FALSE, FALSE, 0);
-      if (i == 1)
-        gtk_box_reorder_child (GTK_BOX (box), separator, 0);
-
-      if ((direction == GTK_TEXT_DIR_LTR && i == 0) ||
-          (direction == GTK_TEXT_DIR_RTL && i == 1))
-        gtk_style_context_add_class (gtk_widget_get_style_context (box), GTK_STYLE_CLASS_LEFT);
-      else
-        gtk_style_context_add_class (gtk_widget_get_style_context (box), GTK_STYLE_CLASS_RIGHT);
-
-      gtk_widget_show (box);
-      gtk_widget_set_parent (box, GTK_WIDGET (self));
+  _hdy_header_bar_update_separator_visibility (self);
+}
 
-      if (i == 0) {
-        priv->titlebar_start_box = box;
-        priv->titlebar_start_separator = separator;
-      } else {
-        priv->titlebar_end_box = box;
-        priv->titlebar_end_separator = separator;
-      }
-    }
-    g_strfreev (tokens);
-  }
-  g_free (layout_desc);
+/* The window icon depends on the icon of the window and on the scale factor. */
+static void
+window_icon_changed_cb (HdyHeaderBar *self)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
 
-  _hdy_header_bar_update_separator_visibility (self);
+  priv->window_icon_changed = TRUE;
+  hdy_header_bar_update_window_buttons (self);
 }
 
 static gboolean
@@ -656,40 +913,108 @@ construct_label_box (HdyHeaderBar *self)
   gtk_widget_set_parent (priv->label_box, GTK_WIDGET (self));
 }
 
-static gint
-count_visible_children (HdyHeaderBar *self)
+static void
+invalidate_visible_children (HdyHeaderBar *self)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+
+  priv->visible_children_valid = FALSE;
+  priv->visible_sizes_valid = FALSE;
+}
+
+static void
+ensure_visible_children (HdyHeaderBar *self)
 {
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
   GList *l;
-  Child *child;
-  gint n;
 
-  n = 0;
+  if (priv->visible_children_valid)
+    return;
+
+  g_ptr_array_set_size (priv->visible_children, 0);
+  priv->n_visible_children[GTK_PACK_START] = 0;
+  priv->n_visible_children[GTK_PACK_END] = 0;
+
   for (l = priv->children; l; l = l->next) {
-    child = l->data;
-    if (gtk_widget_get_visible (child->widget))
-      n++;
+    Child *child = l->data;
+
+    if (!gtk_widget_get_visible (child->widget))
+      continue;
+
+    g_ptr_array_add (priv->visible_children, child);
+    priv->n_visible_children[child->pack_type]++;
   }
 
-  return n;
+  priv->visible_children_valid = TRUE;
+  priv->visible_sizes_valid = FALSE;
+}
+
+static gint
+count_visible_children (HdyHeaderBar *self)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+
+  ensure_visible_children (self);
+
+  return priv->visible_children->len;
 }
 
 static gint
 count_visible_children_for_pack_type (HdyHeaderBar *self, GtkPackType pack_type)
 {
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
-  GList *l;
-  Child *child;
-  gint n;
 
-  n = 0;
-  for (l = priv->children; l; l = l->next) {
-    child = l->data;
-    if (gtk_widget_get_visible (child->widget) && child->pack_type == pack_type)
-      n++;
+  ensure_visible_children (self);
+
+  return priv->n_visible_children[pack_type];
+}
+
+static inline Child *
+get_visible_child (HdyHeaderBar *self,
+                   gint          index)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+
+  return g_ptr_array_index (priv->visible_children, index);
+}
+
+/* Copies the widths of the visible children for @for_height into @sizes,
+ * which must be large enough to hold them.
+ *
+ * The children are only measured once per layout cycle: the sizes are
+ * invalidated when measuring the static size of the header bar, which GTK
+ * always does first after a resize got queued, and once it got allocated.
+ */
+static void
+get_visible_children_sizes (HdyHeaderBar     *self,
+                            gint              for_height,
+                            GtkRequestedSize *sizes)
+{
+  HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
+  gint i, n;
+
+  n = count_visible_children (self);
+
+  if (!priv->visible_sizes_valid || priv->visible_sizes_for_height != for_height) {
+    g_array_set_size (priv->visible_sizes, n);
+
+    for (i = 0; i < n; i++) {
+      GtkRequestedSize *size = &g_array_index (priv->visible_sizes, GtkRequestedSize, i);
+      Child *child = get_visible_child (self, i);
+
+      gtk_widget_get_preferred_width_for_height (child->widget,
+                                                 for_height,
+                                                 &size->minimum_size,
+                                                 &size->natural_size);
+      size->data = child;
+    }
+
+    priv->visible_sizes_for_height = for_height;
+    priv->visible_sizes_valid = TRUE;
   }
 
-  return n;
+  for (i = 0; i < n; i++)
+    sizes[i] = g_array_index (priv->visible_sizes, GtkRequestedSize, i);
 }
 
 static gboolean
@@ -727,14 +1052,19 @@ hdy_header_bar_get_size (GtkWidget      *widget,
 {
   HdyHeaderBar *self = HDY_HEADER_BAR (widget);
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
-  GList *l;
   gint n_start_children = 0, n_end_children = 0;
   gint start_min = 0, start_nat = 0;
   gint end_min = 0, end_nat = 0;
   gint center_min = 0, center_nat = 0;
+  gint i, nvis_children;
 
-  for (l = priv->children; l; l = l->next) {
-    Child *child = l->data;
+  /* A new layout cycle starts, so the children may have changed size. */
+  priv->visible_sizes_valid = FALSE;
+
+  nvis_children = count_visible_children (self);
+
+  for (i = 0; i < nvis_children; i++) {
+    Child *child = get_visible_child (self, i);
 
     if (child->pack_type == GTK_PACK_START) {
       if (add_child_size (child->widget, orientation, &start_min, &start_nat))
@@ -801,25 +1131,21 @@ hdy_header_bar_compute_size_for_orientation (GtkWidget *widget,
 {
   HdyHeaderBar *self = HDY_HEADER_BAR (widget);
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
-  GList *children;
+  GtkRequestedSize *sizes;
   gint required_size = 0;
   gint required_natural = 0;
   gint child_size;
   gint child_natural;
-  gint nvis_children = 0;
-
-  for (children = priv->children; children != NULL; children = children->next) {
-    Child *child = children->data;
-
-    if (gtk_widget_get_visible (child->widget)) {
-      gtk_widget_get_preferred_width_for_height (child->widget,
-                                                 avail_size, &child_size, &child_natural);
+  gint nvis_children;
+  gint i;
 
-      required_size += child_size;
-      required_natural += child_natural;
+  nvis_children = count_visible_children (self);
+  sizes = g_newa (GtkRequestedSize, nvis_children);
+  get_visible_children_sizes (self, avail_size, sizes);
 
-      nvis_children += 1;
-    }
+  for (i = 0; i < nvis_children; i++) {
+    required_size += sizes[i].minimum_size;
+    required_natural += sizes[i].natural_size;
   }
 
   if (priv->label_box != NULL) {
@@ -869,12 +1195,10 @@ hdy_header_bar_compute_size_for_opposing_orientation (GtkWidget *widget,
   HdyHeaderBar *self = HDY_HEADER_BAR (widget);
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
   Child *child;
-  GList *children;
   gint nvis_children;
   gint computed_minimum = 0;
   gint computed_natural = 0;
   GtkRequestedSize *sizes;
-  GtkPackType packing;
   gint i;
   gint child_size;
   gint child_minimum;
@@ -889,48 +1213,29 @@ hdy_header_bar_compute_size_for_opposing_orientation (GtkWidget *widget,
   sizes = g_newa (GtkRequestedSize, nvis_children);
 
   /* Retrieve desired size for visible children */
-  for (i = 0, children = priv->children; children; children = children->next) {
-    child = children->data;
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
 
-    if (gtk_widget_get_visible (child->widget)) {
-      gtk_widget_get_preferred_width (child->widget,
-                                      &sizes[i].minimum_size,
-                                      &sizes[i].natural_size);
+    gtk_widget_get_preferred_width (child->widget,
+                                    &sizes[i].minimum_size,
+                                    &sizes[i].natural_size);
 
-      sizes[i].data = child;
-      i += 1;
-    }
+    sizes[i].data = child;
   }
 
   /* Bring children up to size first */
   gtk_distribute_natural_allocation (MAX (0, avail_size), nvis_children, sizes);
 
-  /* Allocate child positions. */
-  for (packing = GTK_PACK_START; packing <= GTK_PACK_END; ++packing) {
-    for (i = 0, children = priv->children; children; children = children->next) {
-      child = children->data;
-
-      /* If widget is not visible, skip it. */
-      if (!gtk_widget_get_visible (child->widget))
-        continue;
+  /* Measure the children's heights for their widths. */
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
+    child_size = sizes[i].minimum_size;
 
-      /* If widget is packed differently skip it, but still increment i,
-       * since widget is visible and will be handled in next loop
-       * iteration.
-       */
-      if (child->pack_type != packing) {
-        i++;
-        continue;
-      }
+    gtk_widget_get_preferred_height_for_width (child->widget,
+                                               child_size, &child_minimum, &child_natural);
 
-      child_size = sizes[i].minimum_size;
-
-      gtk_widget_get_preferred_height_for_width (child->widget,
-                                                 child_size, &child_minimum, &child_natural);
-
-      computed_minimum = MAX (computed_minimum, child_minimum);
-      computed_natural = MAX (computed_natural, child_natural);
-    }
+    computed_minimum = MAX (computed_minimum, child_minimum);
+    computed_natural = MAX (computed_natural, child_natural);
   }
 
   center_min = center_nat = 0;
@@ -1072,12 +1377,13 @@ children_allocate (HdyHeaderBar      *self,
   GtkPackType packing;
   GtkAllocation child_allocation;
   gint x;
-  gint i;
-  GList *l;
+  gint i, nvis_children;
   Child *child;
   gint child_size;
   /* GtkTextDirection direction; */
 
+  nvis_children = count_visible_children (self);
+
   /* Allocate the children on both sides of the title. */
   for (packing = GTK_PACK_START; packing <= GTK_PACK_END; packing++) {
     child_allocation.y = allocation->y;
@@ -1087,14 +1393,11 @@ children_allocate (HdyHeaderBar      *self,
     else
       x = allocation->x + allocation->width - decoration_width[1];
 
-    i = 0;
-    for (l = priv->children; l != NULL; l = l->next) {
-      child = l->data;
-      if (!gtk_widget_get_visible (child->widget))
-        continue;
+    for (i = 0; i < nvis_children; i++) {
+      child = get_visible_child (self, i);
 
       if (child->pack_type != packing)
-        goto next;
+        continue;
 
       child_size = sizes[i].minimum_size;
 
@@ -1128,26 +1431,24 @@ children_allocate (HdyHeaderBar      *self,
         child_allocation.x = allocation->x + allocation->width - (child_allocation.x - allocation->x) - child_allocation.width;
 
       (*allocations)[i] = child_allocation;
-
-      next:
-        i++;
     }
   }
 }
 
 static void
-get_loose_centering_allocations (HdyHeaderBar   *self,
-                                 GtkAllocation  *allocation,
-                                 GtkAllocation **allocations,
-                                 GtkAllocation  *title_allocation,
-                                 gint            decoration_width[2])
+get_loose_centering_allocations (HdyHeaderBar           *self,
+                                 GtkAllocation          *allocation,
+                                 GtkAllocation         **allocations,
+                                 GtkAllocation          *title_allocation,
+                                 gint                    decoration_width[2],
+                                 const GtkRequestedSize *title_request,
+                                 gboolean                title_expands)
 {
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
   GtkRequestedSize *sizes;
   gint width;
   gint nvis_children;
-  GtkRequestedSize title_size = { 0 };
-  gboolean title_expands = FALSE;
+  GtkRequestedSize title_size = *title_request;
   gint side[2] = { 0 };
   gint uniform_expand_bonus[2] = { 0 };
   gint leftover_expand_bonus[2] = { 0 };
@@ -1155,53 +1456,27 @@ get_loose_centering_allocations (HdyHeaderBar   *self,
   gint center_free_space[2] = { 0 };
   gint nexpand_children[2] = { 0 };
   gint center_free_space_min;
-  GList *l;
   gint i;
   Child *child;
   GtkPackType packing;
 
   nvis_children = count_visible_children (self);
   sizes = g_newa (GtkRequestedSize, nvis_children);
+  get_visible_children_sizes (self, allocation->height, sizes);
 
   width = allocation->width - nvis_children * priv->spacing;
 
-  i = 0;
-  for (l = priv->children; l; l = l->next) {
-    child = l->data;
-    if (!gtk_widget_get_visible (child->widget))
-      continue;
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
 
     if (gtk_widget_compute_expand (child->widget, GTK_ORIENTATION_HORIZONTAL))
       nexpand_children[child->pack_type]++;
 
-    gtk_widget_get_preferred_width_for_height (child->widget,
-                                               allocation->height,
-                                               &sizes[i].minimum_size,
-                                               &sizes[i].natural_size);
     width -= sizes[i].minimum_size;
-    i++;
   }
 
-  get_title_size (self, allocation->height, &title_size, &title_expands);
   width -= title_size.minimum_size;
 
-  /* Compute the nominal size of the children filling up each side of the title
-   * in titlebar.
-   */
-  for (packing = GTK_PACK_START; packing <= GTK_PACK_END; packing++) {
-    i = 0;
-    for (l = priv->children; l != NULL; l = l->next) {
-      child = l->data;
-      if (!gtk_widget_get_visible (child->widget))
-        continue;
-
-      if (child->pack_type == packing)
-        side[packing] += sizes[i].minimum_size + priv->spacing;
-
-      i++;
-    }
-  }
-
   /* Distribute the available space for natural expansion of the children. */
   for (packing = GTK_PACK_START; packing <= GTK_PACK_END; packing++)
     width -= decoration_width[packing];
@@ -1211,19 +1486,10 @@ get_loose_centering_allocations (HdyHeaderBar   *self,
   /* Compute the nominal size of the children filling up each side of the title
    * in titlebar.
    */
-  for (packing = GTK_PACK_START; packing <= GTK_PACK_END; packing++) {
-    i = 0;
-    side[packing] = 0;
-    for (l = priv->children; l != NULL; l = l->next) {
-      child = l->data;
-      if (!gtk_widget_get_visible (child->widget))
-        continue;
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
 
-      if (child->pack_type == packing)
-        side[packing] += sizes[i].minimum_size + priv->spacing;
-
-      i++;
-    }
+    side[child->pack_type] += sizes[i].minimum_size + priv->spacing;
   }
 
   /* Figure out how much space is left on each side of the title, and earkmark
@@ -1282,18 +1548,20 @@ get_loose_centering_allocations (HdyHeaderBar   *self,
 }
 
 static void
-get_strict_centering_allocations (HdyHeaderBar   *self,
-                                  GtkAllocation  *allocation,
-                                  GtkAllocation **allocations,
-                                  GtkAllocation  *title_allocation,
-                                  gint            decoration_width[2])
+get_strict_centering_allocations (HdyHeaderBar           *self,
+                                  GtkAllocation          *allocation,
+                                  GtkAllocation         **allocations,
+                                  GtkAllocation          *title_allocation,
+                                  gint                    decoration_width[2],
+                                  const GtkRequestedSize *title_request,
+                                  gboolean                title_expands)
 {
   HdyHeaderBarPrivate *priv = hdy_header_bar_get_instance_private (self);
 
   GtkRequestedSize *children_sizes = { 0 };
   GtkRequestedSize *children_sizes_for_side[2] = { 0 };
   GtkRequestedSize side_size[2] = { 0 }; /* The size requested by each side. */
-  GtkRequestedSize title_size = { 0 }; /* The size requested by the title. */
+  GtkRequestedSize title_size = *title_request; /* The size requested by the title. */
   GtkRequestedSize side_request = { 0 }; /* The maximum size requested by each side, decoration included. */
   gint side_max; /* The maximum space allocatable to each side, decoration included. */
   gint title_leftover; /* The or 0px or 1px leftover from ensuring each side is allocated the same size. */
@@ -1306,16 +1574,13 @@ get_strict_centering_allocations (HdyHeaderBar   *self,
 
   gint nvis_children, n_side_vis_children[2] = { 0 };
   gint nexpand_children[2] = { 0 };
-  gboolean title_expands = FALSE;
-  GList *l;
   gint i;
   Child *child;
   GtkPackType packing;
 
-  get_title_size (self, allocation->height, &title_size, &title_expands);
-
   nvis_children = count_visible_children (self);
   children_sizes = g_newa (GtkRequestedSize, nvis_children);
+  get_visible_children_sizes (self, allocation->height, children_sizes);
   for (packing = GTK_PACK_START; packing <= GTK_PACK_END; packing++) {
     n_side_vis_children[packing] = count_visible_children_for_pack_type (self, packing);
     children_sizes_for_side[packing] = packing == 0 ? children_sizes : children_sizes + n_side_vis_children[packing - 1];
@@ -1325,24 +1590,15 @@ get_strict_centering_allocations (HdyHeaderBar   *self,
   /* Compute the nominal size of the children filling up each side of the title
    * in titlebar.
    */
-  i = 0;
-  for (l = priv->children; l; l = l->next) {
-    child = l->data;
-    if (!gtk_widget_get_visible (child->widget))
-      continue;
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
 
     if (gtk_widget_compute_expand (child->widget, GTK_ORIENTATION_HORIZONTAL))
       nexpand_children[child->pack_type]++;
 
-    gtk_widget_get_preferred_width_for_height (child->widget,
-                                               allocation->height,
-                                               &children_sizes[i].minimum_size,
-                                               &children_sizes[i].natural_size);
     side_size[child->pack_type].minimum_size += children_sizes[i].minimum_size + priv->spacing;
     side_size[child->pack_type].natural_size += children_sizes[i].natural_size + priv->spacing;
     free_space[child->pack_type] -= children_sizes[i].minimum_size + priv->spacing;
-
-    i++;
   }
 
   /* Figure out the space maximum size requests from each side to help centering
@@ -1420,13 +1676,14 @@ hdy_header_bar_size_allocate (GtkWidget     *widget,
   GtkAllocation title_allocation;
   GtkAllocation clip;
   gint nvis_children;
-  GList *l;
   gint i;
   Child *child;
   GtkAllocation child_allocation;
   GtkTextDirection direction;
   GtkWidget *decoration_box[2] = { priv->titlebar_start_box, priv->titlebar_end_box };
   gint decoration_width[2] = { 0 };
+  GtkRequestedSize title_size = { 0 };
+  gboolean title_expands = FALSE;
 
   gtk_render_background_get_clip (gtk_widget_get_style_context (widget),
                                   allocation->x,
@@ -1485,12 +1742,17 @@ hdy_header_bar_size_allocate (GtkWidget     *widget,
     gtk_widget_size_allocate (priv->titlebar_end_box, &child_allocation);
   }
 
+  /* The title and the children are measured once, and the measurements are
+   * shared by both centering policies.
+   */
+  get_title_size (self, allocation->height, &title_size, &title_expands);
+
   /* Get the allocation for widgets on both side of the title. */
   if (gtk_progress_tracker_get_state (&priv->tracker) == GTK_PROGRESS_STATE_AFTER) {
     if (priv->centering_policy == HDY_CENTERING_POLICY_STRICT)
-      get_strict_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width);
+      get_strict_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width, &title_size, title_expands);
     else
-      get_loose_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width);
+      get_loose_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width, &title_size, title_expands);
   } else {
     /* For memory usage optimisation's sake, we will use the allocations
      * variable to store the loose centering allocations and the
@@ -1503,8 +1765,8 @@ hdy_header_bar_size_allocate (GtkWidget     *widget,
     if (priv->centering_policy != HDY_CENTERING_POLICY_STRICT)
       strict_centering_t = 1.0 - strict_centering_t;
 
-    get_loose_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width);
-    get_strict_centering_allocations (self, allocation, &strict_allocations, &strict_title_allocation, decoration_width);
+    get_loose_centering_allocations (self, allocation, &allocations, &title_allocation, decoration_width, &title_size, title_expands);
+    get_strict_centering_allocations (self, allocation, &strict_allocations, &strict_title_allocation, decoration_width, &title_size, title_expands);
 
     for (i = 0; i < nvis_children; i++) {
       allocations[i].x = hdy_lerp (allocations[i].x, strict_allocations[i].x, strict_centering_t);
@@ -1519,14 +1781,10 @@ hdy_header_bar_size_allocate (GtkWidget     *widget,
   }
 
   /* Allocate the children on both sides of the title. */
-  i = 0;
-  for (l = priv->children; l != NULL; l = l->next) {
-    child = l->data;
-    if (!gtk_widget_get_visible (child->widget))
-      continue;
+  for (i = 0; i < nvis_children; i++) {
+    child = get_visible_child (self, i);
 
     gtk_widget_size_allocate (child->widget, &allocations[i]);
-    i++;
   }
 
   /* Allocate the title widget. */
@@ -1535,6 +1793,9 @@ hdy_header_bar_size_allocate (GtkWidget     *widget,
   else if (priv->label_box != NULL)
     gtk_widget_size_allocate (priv->label_box, &title_allocation);
 
+  /* The layout cycle is over. */
+  priv->visible_sizes_valid = FALSE;
+
   gtk_widget_set_clip (widget, &clip);
 }
 
@@ -1558,17 +1819,8 @@ hdy_header_bar_destroy (GtkWidget *widget)
     priv->label_box = NULL;
   }
 
-  if (priv->titlebar_start_box) {
-    gtk_widget_unparent (priv->titlebar_start_box);
-    priv->titlebar_start_box = NULL;
-    priv->titlebar_start_separator = NULL;
-  }
-
-  if (priv->titlebar_end_box) {
-    gtk_widget_unparent (priv->titlebar_end_box);
-    priv->titlebar_end_box = NULL;
-    priv->titlebar_end_separator = NULL;
-  }
+  clear_titlebar_box (HDY_HEADER_BAR (widget), 0);
+  clear_titlebar_box (HDY_HEADER_BAR (widget), 1);
 
   GTK_WIDGET_CLASS (hdy_header_bar_parent_class)->destroy (widget);
 }
@@ -1581,6 +1833,11 @@ hdy_header_bar_finalize (GObject *object)
   g_clear_pointer (&priv->title, g_free);
   g_clear_pointer (&priv->subtitle, g_free);
   g_clear_pointer (&priv->decoration_layout, g_free);
+  g_clear_pointer (&priv->titlebar_layout, g_free);
+  g_clear_pointer (&priv->titlebar_layout_tokens[0], g_strfreev);
+  g_clear_pointer (&priv->titlebar_layout_tokens[1], g_strfreev);
+  g_clear_pointer (&priv->visible_children, g_ptr_array_unref);
+  g_clear_pointer (&priv->visible_sizes, g_array_unref);
   g_clear_object (&priv->controller);
 
   G_OBJECT_CLASS (hdy_header_bar_parent_class)->finalize (object);
@@ -1696,6 +1953,7 @@ notify_child_cb (GObject      *child,
                  GParamSpec   *pspec,
                  HdyHeaderBar *self)
 {
+  invalidate_visible_children (self);
   _hdy_header_bar_update_separator_visibility (self);
 }
 
@@ -1714,6 +1972,7 @@ hdy_header_bar_pack (HdyHeaderBar *self,
   child->pack_type = pack_type;
 
   priv->children = g_list_append (priv->children, child);
+  invalidate_visible_children (self);
 
   gtk_widget_freeze_child_notify (widget);
   gtk_widget_set_parent (widget, GTK_WIDGET (self));
@@ -1770,6 +2029,7 @@ hdy_header_bar_remove (GtkContainer *container,
     g_signal_handlers_disconnect_by_func (widget, notify_child_cb, self);
     gtk_widget_unparent (child->widget);
     priv->children = g_list_delete_link (priv->children, l);
+    invalidate_visible_children (self);
     g_free (child);
     gtk_widget_queue_resize (GTK_WIDGET (container));
     _hdy_header_bar_update_separator_visibility (self);
@@ -1843,6 +2103,7 @@ hdy_header_bar_reorder_child (HdyHeaderBar *self,
     l = g_list_nth (priv->children, position);
 
   priv->children = g_list_insert_before (priv->children, l, child);
+  invalidate_visible_children (self);
   gtk_widget_child_notify (widget, "position");
   gtk_widget_queue_resize (widget);
 }
@@ -1909,6 +2170,7 @@ hdy_header_bar_set_child_property (GtkContainer *container,
   switch (property_id) {
   case CHILD_PROP_PACK_TYPE:
     child->pack_type = g_value_get_enum (value);
+    invalidate_visible_children (self);
     _hdy_header_bar_update_separator_visibility (self);
     gtk_widget_queue_resize (widget);
     break;
@@ -2026,14 +2288,24 @@ hdy_header_bar_hierarchy_changed (GtkWidget *widget,
 
   toplevel = gtk_widget_get_toplevel (widget);
 
-  if (previous_toplevel)
+  if (previous_toplevel) {
     g_signal_handlers_disconnect_by_func (previous_toplevel,
                                           window_state_changed, widget);
+    g_signal_handlers_disconnect_by_func (previous_toplevel,
+                                          window_icon_changed_cb, widget);
+  }
 
   if (toplevel)
     g_signal_connect_after (toplevel, "window-state-event",
                             G_CALLBACK (window_state_changed), widget);
 
+  if (GTK_IS_WINDOW (toplevel)) {
+    g_signal_connect_swapped (toplevel, "notify::icon",
+                              G_CALLBACK (window_icon_changed_cb), widget);
+    g_signal_connect_swapped (toplevel, "notify::icon-name",
+                              G_CALLBACK (window_icon_changed_cb), widget);
+  }
+
   if (priv->window_size_allocated_id > 0) {
     g_signal_handler_disconnect (previous_toplevel, priv->window_size_allocated_id);
     priv->window_size_allocated_id = 0;
@@ -2044,6 +2316,12 @@ hdy_header_bar_hierarchy_changed (GtkWidget *widget,
       g_signal_connect_swapped (toplevel, "size-allocate",
                                 G_CALLBACK (update_is_mobile_window), self);
 
+  /* The window buttons show the icon of the previous window and the state of
+   * its properties, so don't reuse them.
+   */
+  clear_titlebar_box (self, 0);
+  clear_titlebar_box (self, 1);
+
   update_is_mobile_window (self);
   hdy_header_bar_update_window_buttons (self);
 }
@@ -2235,6 +2513,8 @@ hdy_header_bar_init (HdyHeaderBar *self)
   priv->subtitle = NULL;
   priv->custom_title = NULL;
   priv->children = NULL;
+  priv->visible_children = g_ptr_array_new ();
+  priv->visible_sizes = g_array_new (FALSE, FALSE, sizeof (GtkRequestedSize));
   priv->spacing = DEFAULT_SPACING;
   priv->has_subtitle = TRUE;
   priv->decoration_layout = NULL;
@@ -2246,6 +2526,9 @@ hdy_header_bar_init (HdyHeaderBar *self)
 
   priv->controller = hdy_window_handle_controller_new (GTK_WIDGET (self));
 
+  g_signal_connect (self, "notify::scale-factor",
+                    G_CALLBACK (window_icon_changed_cb), NULL);
+
   context = gtk_widget_get_style_context (GTK_WIDGET (self));
   /* Ensure the widget has the titlebar style class. */
   gtk_style_context_add_class (context, "titlebar");
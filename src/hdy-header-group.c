@@ -84,6 +84,8 @@ struct _HdyHeaderGroup
   GSList *children;
   gboolean decorate_all;
   gchar *layout;
+
+  guint update_id;
 };
 
 static void hdy_header_group_buildable_init (GtkBuildableIface *iface);
@@ -112,6 +114,7 @@ enum {
 static GParamSpec *props [N_PROPS];
 
 static void update_decoration_layouts (HdyHeaderGroup *self);
+static void queue_update_decoration_layouts (HdyHeaderGroup *self);
 
 static void
 object_destroyed_cb (HdyHeaderGroupChild *self,
@@ -137,7 +140,7 @@ forward_update_decoration_layouts (HdyHeaderGroupChild *self)
 
   g_signal_emit (header_group, signals[SIGNAL_UPDATE_DECORATION_LAYOUTS], 0);
 
-  update_decoration_layouts (header_group);
+  queue_update_decoration_layouts (header_group);
 }
 
 static void
@@ -250,12 +253,35 @@ hdy_header_group_child_init (HdyHeaderGroupChild *self)
 {
 }
 
+static const gchar *
+hdy_header_group_child_get_decoration_layout (HdyHeaderGroupChild *self)
+{
+  g_assert (HDY_IS_HEADER_GROUP_CHILD (self));
+
+  switch (self->type) {
+  case HDY_HEADER_GROUP_CHILD_TYPE_HEADER_BAR:
+    return hdy_header_bar_get_decoration_layout (HDY_HEADER_BAR (self->object));
+  case HDY_HEADER_GROUP_CHILD_TYPE_GTK_HEADER_BAR:
+    return gtk_header_bar_get_decoration_layout (GTK_HEADER_BAR (self->object));
+  case HDY_HEADER_GROUP_CHILD_TYPE_HEADER_GROUP:
+    return HDY_HEADER_GROUP (self->object)->layout;
+  default:
+    g_assert_not_reached ();
+  }
+}
+
 static void
 hdy_header_group_child_set_decoration_layout (HdyHeaderGroupChild *self,
                                               const gchar         *layout)
 {
   g_assert (HDY_IS_HEADER_GROUP_CHILD (self));
 
+  /* Setting a decoration layout rebuilds the window buttons of the header
+   * bars, so avoid doing it when nothing changes.
+   */
+  if (!g_strcmp0 (hdy_header_group_child_get_decoration_layout (self), layout))
+    return;
+
   switch (self->type) {
   case HDY_HEADER_GROUP_CHILD_TYPE_HEADER_BAR:
     hdy_header_bar_set_decoration_layout (HDY_HEADER_BAR (self->object), layout);
@@ -318,6 +344,19 @@ get_child_for_object (HdyHeaderGroup *self,
   return NULL;
 }
 
+static void
+remove_update_idle (HdyHeaderGroup *self)
+{
+  if (self->update_id == 0)
+    return;
+
+  g_source_remove (self->update_id);
+  self->update_id = 0;
+}
+
+/* Computes the final layout of each child, and only then applies it to the
+ * children whose layout actually changed.
+ */
 static void
 update_decoration_layouts (HdyHeaderGroup *self)
 {
@@ -331,6 +370,8 @@ update_decoration_layouts (HdyHeaderGroup *self)
 
   g_return_if_fail (HDY_IS_HEADER_GROUP (self));
 
+  remove_update_idle (self);
+
   children = self->children;
 
   if (children == NULL)
@@ -354,8 +395,6 @@ update_decoration_layouts (HdyHeaderGroup *self)
   for (; children != NULL; children = children->next) {
     HdyHeaderGroupChild *child = HDY_HEADER_GROUP_CHILD (children->data);
 
-    hdy_header_group_child_set_decoration_layout (child, ":");
-
     if (!hdy_header_group_child_get_mapped (child))
       continue;
 
@@ -365,25 +404,55 @@ update_decoration_layouts (HdyHeaderGroup *self)
       end_child = child;
   }
 
-  if (start_child == NULL || end_child == NULL)
-    return;
+  if (start_child != NULL && start_child == end_child) {
+    start_layout = g_strdup (layout);
+  } else if (start_child != NULL) {
+    ends = g_strsplit (layout, ":", 2);
+    if (g_strv_length (ends) >= 2) {
+      start_layout = g_strdup_printf ("%s:", ends[0]);
+      end_layout = g_strdup_printf (":%s", ends[1]);
+    } else {
+      start_layout = g_strdup (":");
+      end_layout = g_strdup (":");
+    }
+  }
 
-  if (start_child == end_child) {
-    hdy_header_group_child_set_decoration_layout (start_child, layout);
+  for (children = self->children; children != NULL; children = children->next) {
+    HdyHeaderGroupChild *child = HDY_HEADER_GROUP_CHILD (children->data);
 
-    return;
+    if (child == start_child)
+      hdy_header_group_child_set_decoration_layout (child, start_layout);
+    else if (child == end_child)
+      hdy_header_group_child_set_decoration_layout (child, end_layout);
+    else
+      hdy_header_group_child_set_decoration_layout (child, ":");
   }
+}
 
-  ends = g_strsplit (layout, ":", 2);
-  if (g_strv_length (ends) >= 2) {
-    start_layout = g_strdup_printf ("%s:", ends[0]);
-    end_layout = g_strdup_printf (":%s", ends[1]);
-  } else {
-    start_layout = g_strdup (":");
-    end_layout = g_strdup (":");
-  }
-  hdy_header_group_child_set_decoration_layout (start_child, start_layout);
-  hdy_header_group_child_set_decoration_layout (end_child, end_layout);
+static gboolean
+update_decoration_layouts_cb (HdyHeaderGroup *self)
+{
+  self->update_id = 0;
+
+  update_decoration_layouts (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Header bars get mapped and unmapped in bulk, e.g. when a leaflet folds, so
+ * coalesce the resulting updates into a single one. Its priority is higher
+ * than the one of redrawing, so it happens before the next frame is drawn.
+ */
+static void
+queue_update_decoration_layouts (HdyHeaderGroup *self)
+{
+  if (self->update_id != 0)
+    return;
+
+  self->update_id =
+    g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                     (GSourceFunc) update_decoration_layouts_cb, self, NULL);
+  g_source_set_name_by_id (self->update_id, "[gtk+] update_decoration_layouts_cb");
 }
 
 static void
@@ -417,7 +486,7 @@ hdy_header_group_add_child (HdyHeaderGroup      *self,
   g_object_weak_ref (G_OBJECT (child), (GWeakNotify) child_destroyed_cb, self);
   g_object_ref (self);
 
-  update_decoration_layouts (self);
+  queue_update_decoration_layouts (self);
 
   g_object_set_data (G_OBJECT (child), "header-group", self);
 }
@@ -523,6 +592,11 @@ hdy_header_group_dispose (GObject *object)
 {
   HdyHeaderGroup *self = (HdyHeaderGroup *)object;
 
+  remove_update_idle (self);
+  g_signal_handlers_disconnect_by_func (gtk_settings_get_default (),
+                                        queue_update_decoration_layouts,
+                                        self);
+
   g_slist_free_full (self->children, (GDestroyNotify) g_object_unref);
   self->children = NULL;
 
@@ -854,7 +928,7 @@ hdy_header_group_init (HdyHeaderGroup *self)
 {
   GtkSettings *settings = gtk_settings_get_default ();
 
-  g_signal_connect_swapped (settings, "notify::gtk-decoration-layout", G_CALLBACK (update_decoration_layouts), self);
+  g_signal_connect_swapped (settings, "notify::gtk-decoration-layout", G_CALLBACK (queue_update_decoration_layouts), self);
 }
 
 static void
@@ -1090,7 +1164,7 @@ hdy_header_group_set_decorate_all (HdyHeaderGroup *self,
 
   self->decorate_all = decorate_all;
 
-  update_decoration_layouts (self);
+  queue_update_decoration_layouts (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DECORATE_ALL]);
 }
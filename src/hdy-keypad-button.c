@@ -242,17 +242,38 @@ hdy_keypad_button_class_init (HdyKeypadButtonClass *klass)
                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
   g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
-
-  gtk_widget_class_set_template_from_resource (widget_class,
-                                               "/sm/puri/handy/ui/hdy-keypad-button.ui");
-  gtk_widget_class_bind_template_child (widget_class, HdyKeypadButton, label);
-  gtk_widget_class_bind_template_child (widget_class, HdyKeypadButton, secondary_label);
 }
 
 static void
 hdy_keypad_button_init (HdyKeypadButton *self)
 {
-  gtk_widget_init_template (GTK_WIDGET (self));
+  GtkWidget *box;
+  GtkStyleContext *context;
+
+  /* The widget tree is built in code rather than from a template, as a keypad
+   * creates many buttons and parsing a template for each of them is slow.
+   */
+  gtk_widget_set_can_focus (GTK_WIDGET (self), TRUE);
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_widget_set_valign (box, GTK_ALIGN_CENTER);
+  g_object_set (box, "margin", 6, NULL);
+  gtk_widget_show (box);
+  gtk_container_add (GTK_CONTAINER (self), box);
+
+  self->label = GTK_LABEL (gtk_label_new (NULL));
+  context = gtk_widget_get_style_context (GTK_WIDGET (self->label));
+  gtk_style_context_add_class (context, "digit");
+  gtk_widget_show (GTK_WIDGET (self->label));
+  gtk_container_add (GTK_CONTAINER (box), GTK_WIDGET (self->label));
+
+  self->secondary_label = GTK_LABEL (gtk_label_new (NULL));
+  gtk_widget_set_no_show_all (GTK_WIDGET (self->secondary_label), TRUE);
+  context = gtk_widget_get_style_context (GTK_WIDGET (self->secondary_label));
+  gtk_style_context_add_class (context, "dim-label");
+  gtk_style_context_add_class (context, "letters");
+  gtk_widget_show (GTK_WIDGET (self->secondary_label));
+  gtk_container_add (GTK_CONTAINER (box), GTK_WIDGET (self->secondary_label));
 
   self->symbols = NULL;
 }
@@ -53,17 +53,43 @@ enum {
 };
 static GParamSpec *props[PROP_LAST_PROP];
 
+static gboolean
+is_valid_symbol (HdyKeypad *self,
+                 gchar      symbol)
+{
+  HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
+
+  if (g_ascii_isdigit (symbol))
+    return TRUE;
+
+  return !priv->symbols_visible && symbol != '\0' && strchr ("#*+", symbol);
+}
+
+
+static void
+insert_symbols (HdyKeypad   *self,
+                const gchar *symbols)
+{
+  HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
+
+  /* The whole string is inserted in a single edit, insert_text_cb() drops the
+   * invalid symbols.
+   */
+  g_signal_emit_by_name (priv->entry, "insert-at-cursor", symbols, NULL);
+}
+
+
 static void
 symbol_clicked (HdyKeypad *self,
                 gchar      symbol)
 {
   HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
-  g_autofree gchar *string = g_strdup_printf ("%c", symbol);
+  gchar string[2] = { symbol, '\0' };
 
   if (!priv->entry)
     return;
 
-  g_signal_emit_by_name (priv->entry, "insert-at-cursor", string, NULL);
+  insert_symbols (self, string);
   /* Set focus to the entry only when it can get focus
    * https://gitlab.gnome.org/GNOME/gtk/issues/2204
    */
@@ -104,20 +130,38 @@ static void
 insert_text_cb (HdyKeypad   *self,
                 gchar       *text,
                 gint         length,
-                gpointer     position,
+                gint        *position,
                 GtkEditable *editable)
 {
-  HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
-
-  g_assert (length == 1);
+  g_autofree gchar *filtered = NULL;
+  gint i, n_valid = 0;
 
-  if (g_ascii_isdigit (*text))
-     return;
+  for (i = 0; i < length; i++)
+    if (is_valid_symbol (self, text[i]))
+      n_valid++;
 
-  if (!priv->symbols_visible && strchr ("#*+", *text))
-     return;
+  /* Let valid text through untouched. */
+  if (n_valid == length)
+    return;
 
   g_signal_stop_emission_by_name (editable, "insert-text");
+
+  if (n_valid == 0)
+    return;
+
+  /* Insert the valid symbols only, in a single edit. Non-ASCII characters are
+   * dropped byte by byte, as none of their bytes is a valid symbol.
+   */
+  filtered = g_new (gchar, n_valid + 1);
+  n_valid = 0;
+  for (i = 0; i < length; i++)
+    if (is_valid_symbol (self, text[i]))
+      filtered[n_valid++] = text[i];
+  filtered[n_valid] = '\0';
+
+  g_signal_handlers_block_by_func (editable, insert_text_cb, self);
+  gtk_editable_insert_text (editable, filtered, n_valid, position);
+  g_signal_handlers_unblock_by_func (editable, insert_text_cb, self);
 }
 
 
@@ -338,35 +382,115 @@ hdy_keypad_class_init (HdyKeypadClass *klass)
 
   g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
 
-  gtk_widget_class_set_template_from_resource (widget_class,
-                                               "/sm/puri/handy/ui/hdy-keypad.ui");
-  gtk_widget_class_bind_template_child_private (widget_class, HdyKeypad, grid);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyKeypad, label_asterisk);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyKeypad, label_hash);
-  gtk_widget_class_bind_template_child_private (widget_class, HdyKeypad, long_press_zero_gesture);
-
-  gtk_widget_class_bind_template_callback (widget_class, button_clicked_cb);
-  gtk_widget_class_bind_template_callback (widget_class, asterisk_button_clicked_cb);
-  gtk_widget_class_bind_template_callback (widget_class, hash_button_clicked_cb);
-  gtk_widget_class_bind_template_callback (widget_class, long_press_zero_cb);
-
   gtk_widget_class_set_accessible_role (widget_class, ATK_ROLE_DIAL);
   gtk_widget_class_set_css_name (widget_class, "keypad");
 }
 
 
+static void
+prepare_button (GtkWidget *button)
+{
+  gtk_widget_set_can_focus (button, TRUE);
+  gtk_widget_set_receives_default (button, TRUE);
+  gtk_widget_set_focus_on_click (button, FALSE);
+}
+
+
+static GtkWidget *
+create_digit_button (HdyKeypad   *self,
+                     const gchar *symbols,
+                     const gchar *show_symbols_property,
+                     gint         left,
+                     gint         top)
+{
+  HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
+  GtkWidget *button = hdy_keypad_button_new (symbols);
+
+  prepare_button (button);
+  g_object_bind_property (self, show_symbols_property,
+                          button, "show-symbols",
+                          G_BINDING_SYNC_CREATE);
+  g_signal_connect_swapped (button, "clicked", G_CALLBACK (button_clicked_cb), self);
+
+  gtk_widget_show (button);
+  gtk_grid_attach (GTK_GRID (priv->grid), button, left, top, 1, 1);
+
+  return button;
+}
+
+
+static GtkWidget *
+create_symbol_button (HdyKeypad   *self,
+                      const gchar *symbol,
+                      GCallback    clicked_cb,
+                      gint         left,
+                      gint         top)
+{
+  HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
+  GtkWidget *button = gtk_button_new ();
+  GtkWidget *label = gtk_label_new (symbol);
+
+  gtk_style_context_add_class (gtk_widget_get_style_context (label), "symbol");
+  gtk_widget_show (label);
+  gtk_container_add (GTK_CONTAINER (button), label);
+
+  prepare_button (button);
+  g_object_bind_property (self, "symbols-visible",
+                          button, "visible",
+                          G_BINDING_SYNC_CREATE);
+  g_signal_connect_swapped (button, "clicked", clicked_cb, self);
+
+  gtk_grid_attach (GTK_GRID (priv->grid), button, left, top, 1, 1);
+
+  return label;
+}
+
+
 static void
 hdy_keypad_init (HdyKeypad *self)
 {
   HdyKeypadPrivate *priv = hdy_keypad_get_instance_private (self);
+  GtkWidget *button_0;
 
   priv->row_spacing = 6;
   priv->column_spacing = 6;
   priv->letters_visible = TRUE;
   priv->symbols_visible = TRUE;
 
-  g_type_ensure (HDY_TYPE_KEYPAD_BUTTON);
-  gtk_widget_init_template (GTK_WIDGET (self));
+  /* The widget tree is built in code rather than from a template, as parsing
+   * the templates of the keypad and of its buttons is slow and keypads are
+   * often recreated.
+   */
+  priv->grid = gtk_grid_new ();
+  gtk_widget_set_can_focus (priv->grid, TRUE);
+  gtk_widget_set_hexpand (priv->grid, FALSE);
+  gtk_widget_set_vexpand (priv->grid, FALSE);
+  gtk_grid_set_column_homogeneous (GTK_GRID (priv->grid), TRUE);
+  g_object_bind_property (self, "row-spacing",
+                          priv->grid, "row-spacing",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (self, "column-spacing",
+                          priv->grid, "column-spacing",
+                          G_BINDING_SYNC_CREATE);
+  gtk_widget_show (priv->grid);
+  gtk_container_add (GTK_CONTAINER (self), priv->grid);
+
+  create_digit_button (self, "1", "letters-visible", 0, 0);
+  create_digit_button (self, "2ABC", "letters-visible", 1, 0);
+  create_digit_button (self, "3DEF", "letters-visible", 2, 0);
+  create_digit_button (self, "4GHI", "letters-visible", 0, 1);
+  create_digit_button (self, "5JKL", "letters-visible", 1, 1);
+  create_digit_button (self, "6MNO", "letters-visible", 2, 1);
+  create_digit_button (self, "7PQRS", "letters-visible", 0, 2);
+  create_digit_button (self, "8TUV", "letters-visible", 1, 2);
+  create_digit_button (self, "9WXYZ", "letters-visible", 2, 2);
+  priv->label_asterisk = create_symbol_button (self, "∗", G_CALLBACK (asterisk_button_clicked_cb), 0, 3);
+  button_0 = create_digit_button (self, "0+", "symbols-visible", 1, 3);
+  priv->label_hash = create_symbol_button (self, "#", G_CALLBACK (hash_button_clicked_cb), 2, 3);
+
+  priv->long_press_zero_gesture = gtk_gesture_long_press_new (button_0);
+  g_signal_connect_swapped (priv->long_press_zero_gesture, "pressed",
+                            G_CALLBACK (long_press_zero_cb), self);
 }
 
 
@@ -791,3 +915,34 @@ hdy_keypad_get_end_action (HdyKeypad *self)
 
   return gtk_grid_get_child_at (GTK_GRID (priv->grid), 2, 3);
 }
+
+
+/**
+ * hdy_keypad_insert:
+ * @self: a #HdyKeypad
+ * @symbols: the symbols to insert
+ *
+ * Inserts @symbols at the cursor position of the entry bound to @self in a
+ * single edit, e.g. to paste or dial a whole number at once. The symbols which
+ * couldn't be typed with @self are dropped. See hdy_keypad_set_entry().
+ *
+ * This does nothing if no entry is bound to @self.
+ *
+ * Since: 1.0
+ */
+void
+hdy_keypad_insert (HdyKeypad   *self,
+                   const gchar *symbols)
+{
+  HdyKeypadPrivate *priv;
+
+  g_return_if_fail (HDY_IS_KEYPAD (self));
+  g_return_if_fail (symbols != NULL);
+
+  priv = hdy_keypad_get_instance_private (self);
+
+  if (!priv->entry || *symbols == '\0')
+    return;
+
+  insert_symbols (self, symbols);
+}
@@ -71,6 +71,9 @@ void             hdy_keypad_set_end_action          (HdyKeypad *self,
                                                      GtkWidget *end_action);
 HDY_AVAILABLE_IN_ALL
 GtkWidget       *hdy_keypad_get_end_action          (HdyKeypad *self);
+HDY_AVAILABLE_IN_ALL
+void             hdy_keypad_insert                  (HdyKeypad   *self,
+                                                     const gchar *symbols);
 
 
 G_END_DECLS
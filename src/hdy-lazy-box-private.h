@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#if !defined(_HANDY_INSIDE) && !defined(HANDY_COMPILATION)
+#error "Only <handy.h> can be included directly."
+#endif
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define HDY_TYPE_LAZY_BOX (hdy_lazy_box_get_type())
+
+G_DECLARE_FINAL_TYPE (HdyLazyBox, hdy_lazy_box, HDY, LAZY_BOX, GtkContainer)
+
+GtkWidget *hdy_lazy_box_new (void);
+
+gint       hdy_lazy_box_get_spacing (HdyLazyBox *self);
+void       hdy_lazy_box_set_spacing (HdyLazyBox *self,
+                                     gint        spacing);
+
+gboolean   hdy_lazy_box_get_lazy (HdyLazyBox *self);
+void       hdy_lazy_box_set_lazy (HdyLazyBox *self,
+                                  gboolean    lazy);
+
+void       hdy_lazy_box_set_vadjustment (HdyLazyBox    *self,
+                                         GtkAdjustment *vadjustment);
+
+G_END_DECLS
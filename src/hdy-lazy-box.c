@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "config.h"
+
+#include "hdy-lazy-box-private.h"
+
+/**
+ * PRIVATE:hdy-lazy-box
+ * @short_description: A vertical box loading its children on demand
+ * @title: HdyLazyBox
+ * @See_also: #HdyPreferencesPage
+ * @stability: Private
+ *
+ * The #HdyLazyBox widget stacks its children vertically like a #GtkBox.
+ *
+ * When lazy, the children far from the visible area of its vertical adjustment
+ * aren't measured, allocated nor mapped, and an estimate of their height is
+ * used instead. They get loaded as they are scrolled near the visible area, or
+ * when they get the focus, and stay loaded afterwards.
+ *
+ * Since: 1.0
+ */
+
+/* How far from the visible area the children get loaded, in pixels. */
+#define LOAD_DISTANCE 1000
+/* The height of the unloaded children when no child was allocated yet. */
+#define DEFAULT_ESTIMATED_HEIGHT 200
+
+typedef struct _HdyLazyBoxChildInfo HdyLazyBoxChildInfo;
+
+struct _HdyLazyBoxChildInfo
+{
+  GtkWidget *widget;
+  gboolean loaded;
+  /* The last allocated height, or 0 if it was never allocated. */
+  gint height;
+};
+
+struct _HdyLazyBox
+{
+  GtkContainer parent_instance;
+
+  GList *children;
+  gint spacing;
+  gboolean lazy;
+  GtkAdjustment *vadjustment;
+
+  /* The average height of the allocated children, used as an estimate. */
+  gint estimated_height;
+};
+
+G_DEFINE_TYPE (HdyLazyBox, hdy_lazy_box, GTK_TYPE_CONTAINER)
+
+static HdyLazyBoxChildInfo *
+find_child_info (HdyLazyBox *self,
+                 GtkWidget  *widget)
+{
+  GList *l;
+
+  for (l = self->children; l; l = l->next) {
+    HdyLazyBoxChildInfo *info = l->data;
+
+    if (widget == info->widget)
+      return info;
+  }
+
+  return NULL;
+}
+
+static gint
+get_child_height (HdyLazyBox          *self,
+                  HdyLazyBoxChildInfo *info)
+{
+  return info->height > 0 ? info->height : self->estimated_height;
+}
+
+/* Marks the children near the visible area as loaded, returns whether any
+ * child got loaded.
+ */
+static gboolean
+load_visible_children (HdyLazyBox *self)
+{
+  GtkAllocation allocation;
+  gdouble value = 0, page_size = 0;
+  gint y, lower, upper;
+  gboolean loaded_any = FALSE;
+  GList *l;
+
+  if (!self->lazy)
+    return FALSE;
+
+  if (self->vadjustment) {
+    value = gtk_adjustment_get_value (self->vadjustment);
+    page_size = gtk_adjustment_get_page_size (self->vadjustment);
+  }
+
+  /* The allocation is in the coordinates of the scrolled content, or is empty
+   * if the box was never allocated.
+   */
+  gtk_widget_get_allocation (GTK_WIDGET (self), &allocation);
+
+  y = MAX (allocation.y, 0);
+  lower = (gint) value - LOAD_DISTANCE;
+  upper = (gint) (value + page_size) + LOAD_DISTANCE;
+
+  for (l = self->children; l && y <= upper; l = l->next) {
+    HdyLazyBoxChildInfo *info = l->data;
+    gint height;
+
+    if (!gtk_widget_get_visible (info->widget))
+      continue;
+
+    height = get_child_height (self, info);
+
+    if (!info->loaded && y + height >= lower) {
+      info->loaded = TRUE;
+      loaded_any = TRUE;
+    }
+
+    y += height + self->spacing;
+  }
+
+  return loaded_any;
+}
+
+static void
+load_child (HdyLazyBox          *self,
+            HdyLazyBoxChildInfo *info)
+{
+  if (info->loaded)
+    return;
+
+  info->loaded = TRUE;
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+adjustment_changed_cb (HdyLazyBox *self)
+{
+  if (load_visible_children (self))
+    gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+measure (GtkWidget      *widget,
+         GtkOrientation  orientation,
+         gint            for_size,
+         gint           *minimum,
+         gint           *natural,
+         gint           *minimum_baseline,
+         gint           *natural_baseline)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (widget);
+  gint n_visible_children = 0;
+  GList *l;
+
+  *minimum = 0;
+  *natural = 0;
+
+  for (l = self->children; l; l = l->next) {
+    HdyLazyBoxChildInfo *info = l->data;
+    gint child_min = 0, child_nat = 0;
+
+    if (!gtk_widget_get_visible (info->widget))
+      continue;
+
+    n_visible_children++;
+
+    if (orientation == GTK_ORIENTATION_HORIZONTAL) {
+      if (info->loaded)
+        gtk_widget_get_preferred_width (info->widget, &child_min, &child_nat);
+
+      *minimum = MAX (*minimum, child_min);
+      *natural = MAX (*natural, child_nat);
+
+      continue;
+    }
+
+    if (!info->loaded)
+      child_min = child_nat = get_child_height (self, info);
+    else if (for_size < 0)
+      gtk_widget_get_preferred_height (info->widget, &child_min, &child_nat);
+    else
+      gtk_widget_get_preferred_height_for_width (info->widget, for_size, &child_min, &child_nat);
+
+    *minimum += child_min;
+    *natural += child_nat;
+  }
+
+  if (orientation == GTK_ORIENTATION_VERTICAL && n_visible_children > 0) {
+    *minimum += self->spacing * (n_visible_children - 1);
+    *natural += self->spacing * (n_visible_children - 1);
+  }
+
+  if (minimum_baseline)
+    *minimum_baseline = -1;
+  if (natural_baseline)
+    *natural_baseline = -1;
+}
+
+static GtkSizeRequestMode
+hdy_lazy_box_get_request_mode (GtkWidget *widget)
+{
+  return GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH;
+}
+
+static void
+hdy_lazy_box_get_preferred_width (GtkWidget *widget,
+                                  gint      *minimum_width,
+                                  gint      *natural_width)
+{
+  measure (widget, GTK_ORIENTATION_HORIZONTAL, -1,
+           minimum_width, natural_width, NULL, NULL);
+}
+
+static void
+hdy_lazy_box_get_preferred_height (GtkWidget *widget,
+                                   gint      *minimum_height,
+                                   gint      *natural_height)
+{
+  measure (widget, GTK_ORIENTATION_VERTICAL, -1,
+           minimum_height, natural_height, NULL, NULL);
+}
+
+static void
+hdy_lazy_box_get_preferred_width_for_height (GtkWidget *widget,
+                                             gint       for_height,
+                                             gint      *minimum_width,
+                                             gint      *natural_width)
+{
+  measure (widget, GTK_ORIENTATION_HORIZONTAL, for_height,
+           minimum_width, natural_width, NULL, NULL);
+}
+
+static void
+hdy_lazy_box_get_preferred_height_for_width (GtkWidget *widget,
+                                             gint       for_width,
+                                             gint      *minimum_height,
+                                             gint      *natural_height)
+{
+  measure (widget, GTK_ORIENTATION_VERTICAL, for_width,
+           minimum_height, natural_height, NULL, NULL);
+}
+
+static void
+hdy_lazy_box_size_allocate (GtkWidget     *widget,
+                            GtkAllocation *allocation)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (widget);
+  gint y = allocation->y;
+  gint allocated_height = 0, n_allocated = 0;
+  GList *l;
+
+  gtk_widget_set_allocation (widget, allocation);
+
+  /* Children are only loaded here and from the adjustment handlers, never
+   * while measuring. The newly loaded ones are allocated right away, and the
+   * box is measured again with their actual size.
+   */
+  if (load_visible_children (self))
+    gtk_widget_queue_resize (widget);
+
+  for (l = self->children; l; l = l->next) {
+    HdyLazyBoxChildInfo *info = l->data;
+    GtkAllocation child_allocation;
+    gint child_min, child_nat;
+
+    if (!gtk_widget_get_visible (info->widget))
+      continue;
+
+    if (!info->loaded) {
+      y += get_child_height (self, info) + self->spacing;
+
+      continue;
+    }
+
+    /* The box is meant to be scrolled, so it always gets at least its natural
+     * height and its children get theirs.
+     */
+    gtk_widget_get_preferred_height_for_width (info->widget, allocation->width,
+                                               &child_min, &child_nat);
+
+    child_allocation.x = allocation->x;
+    child_allocation.y = y;
+    child_allocation.width = allocation->width;
+    child_allocation.height = child_nat;
+
+    gtk_widget_size_allocate (info->widget, &child_allocation);
+
+    /* Only map the child once it is allocated. */
+    if (!gtk_widget_get_child_visible (info->widget))
+      gtk_widget_set_child_visible (info->widget, TRUE);
+
+    info->height = child_nat;
+    allocated_height += child_nat;
+    n_allocated++;
+
+    y += child_nat + self->spacing;
+  }
+
+  if (n_allocated > 0)
+    self->estimated_height = MAX (allocated_height / n_allocated, 1);
+}
+
+static void
+hdy_lazy_box_add (GtkContainer *container,
+                  GtkWidget    *widget)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (container);
+  HdyLazyBoxChildInfo *info = g_new0 (HdyLazyBoxChildInfo, 1);
+
+  info->widget = widget;
+  info->loaded = !self->lazy;
+
+  self->children = g_list_append (self->children, info);
+
+  /* Unloaded children must not be mapped, as they aren't allocated. */
+  gtk_widget_set_child_visible (widget, info->loaded);
+  gtk_widget_set_parent (widget, GTK_WIDGET (self));
+}
+
+static void
+hdy_lazy_box_remove (GtkContainer *container,
+                     GtkWidget    *widget)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (container);
+  HdyLazyBoxChildInfo *info = find_child_info (self, widget);
+  gboolean was_visible;
+
+  if (!info)
+    return;
+
+  was_visible = gtk_widget_get_visible (widget);
+
+  self->children = g_list_remove (self->children, info);
+  g_free (info);
+
+  gtk_widget_unparent (widget);
+
+  if (was_visible && gtk_widget_get_visible (GTK_WIDGET (self)))
+    gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+hdy_lazy_box_forall (GtkContainer *container,
+                     gboolean      include_internals,
+                     GtkCallback   callback,
+                     gpointer      callback_data)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (container);
+  GList *l = self->children;
+
+  /* The callback may remove the current child. */
+  while (l) {
+    HdyLazyBoxChildInfo *info = l->data;
+
+    l = l->next;
+
+    (* callback) (info->widget, callback_data);
+  }
+}
+
+static void
+hdy_lazy_box_set_focus_child (GtkContainer *container,
+                              GtkWidget    *widget)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (container);
+
+  /* Load the children receiving the focus, so they can be scrolled to. */
+  if (widget != NULL) {
+    HdyLazyBoxChildInfo *info = find_child_info (self, widget);
+
+    if (info != NULL)
+      load_child (self, info);
+  }
+
+  GTK_CONTAINER_CLASS (hdy_lazy_box_parent_class)->set_focus_child (container, widget);
+}
+
+static void
+hdy_lazy_box_dispose (GObject *object)
+{
+  HdyLazyBox *self = HDY_LAZY_BOX (object);
+
+  hdy_lazy_box_set_vadjustment (self, NULL);
+
+  G_OBJECT_CLASS (hdy_lazy_box_parent_class)->dispose (object);
+}
+
+static void
+hdy_lazy_box_class_init (HdyLazyBoxClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+  GtkContainerClass *container_class = GTK_CONTAINER_CLASS (klass);
+
+  object_class->dispose = hdy_lazy_box_dispose;
+
+  widget_class->get_request_mode = hdy_lazy_box_get_request_mode;
+  widget_class->get_preferred_width = hdy_lazy_box_get_preferred_width;
+  widget_class->get_preferred_height = hdy_lazy_box_get_preferred_height;
+  widget_class->get_preferred_width_for_height = hdy_lazy_box_get_preferred_width_for_height;
+  widget_class->get_preferred_height_for_width = hdy_lazy_box_get_preferred_height_for_width;
+  widget_class->size_allocate = hdy_lazy_box_size_allocate;
+
+  container_class->add = hdy_lazy_box_add;
+  container_class->remove = hdy_lazy_box_remove;
+  container_class->forall = hdy_lazy_box_forall;
+  container_class->set_focus_child = hdy_lazy_box_set_focus_child;
+  gtk_container_class_handle_border_width (container_class);
+}
+
+static void
+hdy_lazy_box_init (HdyLazyBox *self)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (self), FALSE);
+
+  self->estimated_height = DEFAULT_ESTIMATED_HEIGHT;
+}
+
+/**
+ * hdy_lazy_box_new:
+ *
+ * Creates a new #HdyLazyBox.
+ *
+ * Returns: a new #HdyLazyBox
+ *
+ * Since: 1.0
+ */
+GtkWidget *
+hdy_lazy_box_new (void)
+{
+  return g_object_new (HDY_TYPE_LAZY_BOX, NULL);
+}
+
+/**
+ * hdy_lazy_box_get_spacing:
+ * @self: a #HdyLazyBox
+ *
+ * Gets the spacing between the children of @self.
+ *
+ * Returns: the spacing between the children of @self
+ *
+ * Since: 1.0
+ */
+gint
+hdy_lazy_box_get_spacing (HdyLazyBox *self)
+{
+  g_return_val_if_fail (HDY_IS_LAZY_BOX (self), 0);
+
+  return self->spacing;
+}
+
+/**
+ * hdy_lazy_box_set_spacing:
+ * @self: a #HdyLazyBox
+ * @spacing: the spacing between the children
+ *
+ * Sets the spacing between the children of @self.
+ *
+ * Since: 1.0
+ */
+void
+hdy_lazy_box_set_spacing (HdyLazyBox *self,
+                          gint        spacing)
+{
+  g_return_if_fail (HDY_IS_LAZY_BOX (self));
+  g_return_if_fail (spacing >= 0);
+
+  if (self->spacing == spacing)
+    return;
+
+  self->spacing = spacing;
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+/**
+ * hdy_lazy_box_get_lazy:
+ * @self: a #HdyLazyBox
+ *
+ * Gets whether @self loads its children on demand.
+ *
+ * Returns: whether @self loads its children on demand
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_lazy_box_get_lazy (HdyLazyBox *self)
+{
+  g_return_val_if_fail (HDY_IS_LAZY_BOX (self), FALSE);
+
+  return self->lazy;
+}
+
+/**
+ * hdy_lazy_box_set_lazy:
+ * @self: a #HdyLazyBox
+ * @lazy: whether to load the children on demand
+ *
+ * Sets whether @self loads its children on demand. Only the children added
+ * afterwards are affected when enabling it, while disabling it loads all the
+ * children.
+ *
+ * Since: 1.0
+ */
+void
+hdy_lazy_box_set_lazy (HdyLazyBox *self,
+                       gboolean    lazy)
+{
+  GList *l;
+
+  g_return_if_fail (HDY_IS_LAZY_BOX (self));
+
+  lazy = !!lazy;
+
+  if (self->lazy == lazy)
+    return;
+
+  self->lazy = lazy;
+
+  if (lazy)
+    return;
+
+  for (l = self->children; l; l = l->next)
+    load_child (self, l->data);
+}
+
+/**
+ * hdy_lazy_box_set_vadjustment:
+ * @self: a #HdyLazyBox
+ * @vadjustment: (nullable): the vertical adjustment @self is scrolled with
+ *
+ * Sets the vertical adjustment @self is scrolled with, which defines which
+ * children are near the visible area.
+ *
+ * Since: 1.0
+ */
+void
+hdy_lazy_box_set_vadjustment (HdyLazyBox    *self,
+                              GtkAdjustment *vadjustment)
+{
+  g_return_if_fail (HDY_IS_LAZY_BOX (self));
+  g_return_if_fail (vadjustment == NULL || GTK_IS_ADJUSTMENT (vadjustment));
+
+  if (self->vadjustment == vadjustment)
+    return;
+
+  if (self->vadjustment)
+    g_signal_handlers_disconnect_by_func (self->vadjustment, adjustment_changed_cb, self);
+
+  g_set_object (&self->vadjustment, vadjustment);
+
+  if (self->vadjustment) {
+    g_signal_connect_swapped (self->vadjustment, "value-changed", G_CALLBACK (adjustment_changed_cb), self);
+    g_signal_connect_swapped (self->vadjustment, "changed", G_CALLBACK (adjustment_changed_cb), self);
+  }
+}
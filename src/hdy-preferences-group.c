@@ -7,7 +7,7 @@
 #include "config.h"
 #include <glib/gi18n-lib.h>
 
-#include "hdy-preferences-group-private.h"
+#include "hdy-preferences-group.h"
 
 #include "hdy-preferences-row.h"
 
@@ -403,47 +403,3 @@ hdy_preferences_group_set_description (HdyPreferencesGroup *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DESCRIPTION]);
 }
-
-static void
-add_preferences_to_model (HdyPreferencesRow *row,
-                          GListStore        *model)
-{
-  const gchar *title;
-
-  g_assert (HDY_IS_PREFERENCES_ROW (row));
-  g_assert (G_IS_LIST_STORE (model));
-
-  if (!gtk_widget_get_visible (GTK_WIDGET (row)))
-    return;
-
-  title = hdy_preferences_row_get_title (row);
-
-  if (!title || !*title)
-    return;
-
-  g_list_store_append (model, row);
-}
-
-/**
- * hdy_preferences_group_add_preferences_to_model: (skip)
- * @self: a #HdyPreferencesGroup
- * @model: the model
- *
- * Add preferences from @self to the model.
- *
- * Since: 0.0.10
- */
-void
-hdy_preferences_group_add_preferences_to_model (HdyPreferencesGroup *self,
-                                                GListStore          *model)
-{
-  HdyPreferencesGroupPrivate *priv = hdy_preferences_group_get_instance_private (self);
-
-  g_return_if_fail (HDY_IS_PREFERENCES_GROUP (self));
-  g_return_if_fail (G_IS_LIST_STORE (model));
-
-  if (!gtk_widget_get_visible (GTK_WIDGET (self)))
-    return;
-
-  gtk_container_foreach (GTK_CONTAINER (priv->listbox), (GtkCallback) add_preferences_to_model, model);
-}
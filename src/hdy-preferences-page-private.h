@@ -12,7 +12,4 @@ G_BEGIN_DECLS
 
 GtkAdjustment *hdy_preferences_page_get_vadjustment (HdyPreferencesPage *self);
 
-void hdy_preferences_page_add_preferences_to_model (HdyPreferencesPage *self,
-                                                    GListStore         *model);
-
 G_END_DECLS
@@ -9,7 +9,7 @@
 
 #include "hdy-preferences-page-private.h"
 
-#include "hdy-preferences-group-private.h"
+#include "hdy-lazy-box-private.h"
 
 /**
  * SECTION:hdy-preferences-page
@@ -19,6 +19,9 @@
  * The #HdyPreferencesPage widget gathers preferences groups into a single page
  * of a preferences window.
  *
+ * Pages with many groups can be made lazy, see
+ * hdy_preferences_page_set_lazy().
+ *
  * # CSS nodes
  *
  * #HdyPreferencesPage has a single CSS node with name preferencespage.
@@ -28,7 +31,7 @@
 
 typedef struct
 {
-  GtkBox *box;
+  HdyLazyBox *box;
   GtkScrolledWindow *scrolled_window;
 
   gchar *icon_name;
@@ -41,6 +44,7 @@ enum {
   PROP_0,
   PROP_ICON_NAME,
   PROP_TITLE,
+  PROP_LAZY,
   LAST_PROP,
 };
 
@@ -67,6 +71,9 @@ hdy_preferences_page_get_property (GObject    *object,
   case PROP_TITLE:
     g_value_set_string (value, hdy_preferences_page_get_title (self));
     break;
+  case PROP_LAZY:
+    g_value_set_boolean (value, hdy_preferences_page_get_lazy (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -87,6 +94,9 @@ hdy_preferences_page_set_property (GObject      *object,
   case PROP_TITLE:
     hdy_preferences_page_set_title (self, g_value_get_string (value));
     break;
+  case PROP_LAZY:
+    hdy_preferences_page_set_lazy (self, g_value_get_boolean (value));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -195,6 +205,21 @@ hdy_preferences_page_class_init (HdyPreferencesPageClass *klass)
                          "",
                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * HdyPreferencesPage:lazy:
+   *
+   * Whether the groups added to this page are only loaded once they are
+   * scrolled near the visible area. See hdy_preferences_page_set_lazy().
+   *
+   * Since: 1.0
+   */
+  props[PROP_LAZY] =
+    g_param_spec_boolean ("lazy",
+                          _("Lazy"),
+                          _("Whether the groups are only loaded once they are scrolled near the visible area"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   gtk_widget_class_set_template_from_resource (widget_class,
@@ -208,7 +233,13 @@ hdy_preferences_page_class_init (HdyPreferencesPageClass *klass)
 static void
 hdy_preferences_page_init (HdyPreferencesPage *self)
 {
+  HdyPreferencesPagePrivate *priv = hdy_preferences_page_get_instance_private (self);
+
+  g_type_ensure (HDY_TYPE_LAZY_BOX);
   gtk_widget_init_template (GTK_WIDGET (self));
+
+  hdy_lazy_box_set_spacing (priv->box, 18);
+  hdy_lazy_box_set_vadjustment (priv->box, gtk_scrolled_window_get_vadjustment (priv->scrolled_window));
 }
 
 /**
@@ -326,40 +357,74 @@ hdy_preferences_page_set_title (HdyPreferencesPage *self,
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_TITLE]);
 }
 
-GtkAdjustment *
-hdy_preferences_page_get_vadjustment (HdyPreferencesPage *self)
+/**
+ * hdy_preferences_page_get_lazy:
+ * @self: a #HdyPreferencesPage
+ *
+ * Gets whether the groups added to @self are only loaded once they are
+ * scrolled near the visible area.
+ *
+ * Returns: whether @self is lazy
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_preferences_page_get_lazy (HdyPreferencesPage *self)
 {
   HdyPreferencesPagePrivate *priv;
 
-  g_return_val_if_fail (HDY_IS_PREFERENCES_PAGE (self), NULL);
+  g_return_val_if_fail (HDY_IS_PREFERENCES_PAGE (self), FALSE);
 
   priv = hdy_preferences_page_get_instance_private (self);
 
-  return gtk_scrolled_window_get_vadjustment (priv->scrolled_window);
+  return hdy_lazy_box_get_lazy (priv->box);
 }
 
 /**
- * hdy_preferences_page_add_preferences_to_model: (skip)
+ * hdy_preferences_page_set_lazy:
  * @self: a #HdyPreferencesPage
- * @model: the model
+ * @lazy: whether the groups should be loaded on demand
  *
- * Add preferences from @self to the model.
+ * Sets whether the groups added to @self are only loaded once they are
+ * scrolled near the visible area, or once they receive the focus.
  *
- * Since: 0.0.10
+ * Until then, a group isn't measured, allocated nor mapped, and its height is
+ * estimated from the height of the loaded groups. This makes showing pages
+ * with many rows faster, at the cost of the scrollbar being approximate.
+ *
+ * This only affects the groups added afterwards, so it should be set before
+ * adding groups. Disabling it loads all the groups.
+ *
+ * Since: 1.0
  */
 void
-hdy_preferences_page_add_preferences_to_model (HdyPreferencesPage *self,
-                                               GListStore         *model)
+hdy_preferences_page_set_lazy (HdyPreferencesPage *self,
+                               gboolean            lazy)
 {
   HdyPreferencesPagePrivate *priv;
 
   g_return_if_fail (HDY_IS_PREFERENCES_PAGE (self));
-  g_return_if_fail (G_IS_LIST_STORE (model));
 
-  if (!gtk_widget_get_visible (GTK_WIDGET (self)))
+  priv = hdy_preferences_page_get_instance_private (self);
+
+  lazy = !!lazy;
+
+  if (hdy_lazy_box_get_lazy (priv->box) == lazy)
     return;
 
+  hdy_lazy_box_set_lazy (priv->box, lazy);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_LAZY]);
+}
+
+GtkAdjustment *
+hdy_preferences_page_get_vadjustment (HdyPreferencesPage *self)
+{
+  HdyPreferencesPagePrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_PREFERENCES_PAGE (self), NULL);
+
   priv = hdy_preferences_page_get_instance_private (self);
 
-  gtk_container_foreach (GTK_CONTAINER (priv->box), (GtkCallback) hdy_preferences_group_add_preferences_to_model, model);
+  return gtk_scrolled_window_get_vadjustment (priv->scrolled_window);
 }
@@ -48,4 +48,10 @@ HDY_AVAILABLE_IN_ALL
 void         hdy_preferences_page_set_title (HdyPreferencesPage *self,
                                              const gchar        *title);
 
+HDY_AVAILABLE_IN_ALL
+gboolean     hdy_preferences_page_get_lazy (HdyPreferencesPage *self);
+HDY_AVAILABLE_IN_ALL
+void         hdy_preferences_page_set_lazy (HdyPreferencesPage *self,
+                                            gboolean            lazy);
+
 G_END_DECLS
@@ -12,7 +12,7 @@
 #include "hdy-animation.h"
 #include "hdy-action-row.h"
 #include "hdy-deck.h"
-#include "hdy-preferences-group-private.h"
+#include "hdy-preferences-group.h"
 #include "hdy-preferences-page-private.h"
 #include "hdy-view-switcher.h"
 #include "hdy-view-switcher-bar.h"
@@ -45,124 +45,723 @@ typedef struct
 
   gboolean search_enabled;
   gboolean can_swipe_back;
-  gint n_last_search_results;
+  gboolean fuzzy_search;
+  guint max_search_results;
   GtkWidget *subpage;
+
+  GPtrArray *search_index;
+  GHashTable *search_entries;
+  GPtrArray *search_hits;
+  GPtrArray *search_result_pool;
+  gchar *search_query;
+  gboolean search_index_valid;
+  guint search_index_update_id;
+
+  HdyPreferencesRow *scroll_row;
+  gulong scroll_row_map_id;
 } HdyPreferencesWindowPrivate;
 
+/* An entry of the search index, it references a searchable preference row and
+ * keeps the casefolded keys it is matched against. Only the displayed entries
+ * are bound to a result row.
+ */
+typedef struct
+{
+  HdyPreferencesRow *row;
+  HdyPreferencesPage *page;
+  gchar *subtitle;
+  gchar *title_key;
+  gchar *subtitle_key;
+  guint position;
+  guint score;
+  GtkWidget *result;
+} SearchEntry;
+
+typedef struct
+{
+  HdyPreferencesWindow *self;
+  HdyPreferencesPage *page;
+  HdyPreferencesGroup *group;
+  const gchar *subtitle;
+  gchar *subtitle_key;
+} IndexData;
+
 G_DEFINE_TYPE_WITH_PRIVATE (HdyPreferencesWindow, hdy_preferences_window, HDY_TYPE_WINDOW)
 
 enum {
   PROP_0,
   PROP_SEARCH_ENABLED,
   PROP_CAN_SWIPE_BACK,
+  PROP_FUZZY_SEARCH,
+  PROP_MAX_SEARCH_RESULTS,
   LAST_PROP,
 };
 
 static GParamSpec *props[LAST_PROP];
 
-static gboolean
-filter_search_results (HdyActionRow         *row,
-                       HdyPreferencesWindow *self)
+static void
+search_entry_free (SearchEntry *entry)
+{
+  g_object_unref (entry->row);
+  g_object_unref (entry->page);
+  g_free (entry->subtitle);
+  g_free (entry->title_key);
+  g_free (entry->subtitle_key);
+  g_free (entry);
+}
+
+static GtkWidget *
+new_search_result (void)
+{
+  GtkWidget *widget = hdy_action_row_new ();
+
+  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (widget), TRUE);
+
+  return widget;
+}
+
+/* Result rows are recycled rather than bound to their preference rows with
+ * property bindings, so the title and the use-underline property are synced
+ * by the index when binding them and when they change.
+ */
+static void
+bind_search_result (GtkWidget   *result,
+                    SearchEntry *entry)
+{
+  HdyActionRow *widget = HDY_ACTION_ROW (result);
+
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (widget),
+                                 hdy_preferences_row_get_title (entry->row));
+  hdy_preferences_row_set_use_underline (HDY_PREFERENCES_ROW (widget),
+                                         hdy_preferences_row_get_use_underline (entry->row));
+  hdy_action_row_set_subtitle (widget, entry->subtitle);
+
+  g_object_set_data (G_OBJECT (widget), "entry", entry);
+  entry->result = result;
+}
+
+/* How well a query matches a key, from the worst to the best. */
+typedef enum {
+  MATCH_NONE,
+  MATCH_SUBSEQUENCE,
+  MATCH_SUBSTRING,
+  MATCH_WORD_START,
+  MATCH_PREFIX,
+} MatchQuality;
+
+static MatchQuality
+match_key (const gchar *key,
+           const gchar *query)
+{
+  const gchar *match = strstr (key, query);
+
+  if (match == key)
+    return MATCH_PREFIX;
+
+  if (match != NULL) {
+    for (; match != NULL; match = strstr (g_utf8_next_char (match), query))
+      if (!g_unichar_isalnum (g_utf8_get_char (g_utf8_prev_char (match))))
+        return MATCH_WORD_START;
+
+    return MATCH_SUBSTRING;
+  }
+
+  for (; *query; query = g_utf8_next_char (query)) {
+    key = g_utf8_strchr (key, -1, g_utf8_get_char (query));
+
+    if (key == NULL)
+      return MATCH_NONE;
+
+    key = g_utf8_next_char (key);
+  }
+
+  return MATCH_SUBSEQUENCE;
+}
+
+/* Returns: 0 if @query doesn't match @entry, otherwise a score which is higher
+ * for better matches. When fuzzy search is enabled, title matches rank above
+ * subtitle matches of the same quality.
+ */
+static guint
+score_search_entry (SearchEntry *entry,
+                    const gchar *query,
+                    gboolean     fuzzy)
+{
+  MatchQuality title_match, subtitle_match;
+
+  if (!fuzzy)
+    return strstr (entry->title_key, query) != NULL ||
+           strstr (entry->subtitle_key, query) != NULL;
+
+  title_match = match_key (entry->title_key, query);
+
+  if (title_match == MATCH_PREFIX)
+    return 2 * MATCH_PREFIX;
+
+  subtitle_match = match_key (entry->subtitle_key, query);
+
+  if (subtitle_match > title_match)
+    return 2 * subtitle_match - 1;
+
+  return 2 * title_match;
+}
+
+static gint
+compare_search_entries (const SearchEntry *a,
+                        const SearchEntry *b)
+{
+  if (a->score != b->score)
+    return a->score > b->score ? -1 : 1;
+
+  return a->position < b->position ? -1 : a->position > b->position;
+}
+
+static gint
+compare_search_hits (SearchEntry **a,
+                     SearchEntry **b)
+{
+  return compare_search_entries (*a, *b);
+}
+
+static gint
+sort_search_results (GtkListBoxRow        *a,
+                     GtkListBoxRow        *b,
+                     HdyPreferencesWindow *self)
 {
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
-  g_autofree gchar *text = g_utf8_casefold (gtk_entry_get_text (GTK_ENTRY (priv->search_entry)), -1);
-  g_autofree gchar *title = g_utf8_casefold (hdy_preferences_row_get_title (HDY_PREFERENCES_ROW (row)), -1);
-  g_autofree gchar *subtitle = NULL;
+  SearchEntry *entry_a = g_object_get_data (G_OBJECT (a), "entry");
+  SearchEntry *entry_b = g_object_get_data (G_OBJECT (b), "entry");
 
-  /* The CSS engine works in such a way that invisible children are treated as
-   * visible widgets, which breaks the expectations of the .preferences  style
-   * class when filtering a row, leading to straight corners when the first row
-   * or last row are filtered out.
-   *
-   * This works around it by explicitly toggling the row's visibility, while
-   * keeping GtkListBox's filtering logic.
-   *
-   * See https://gitlab.gnome.org/GNOME/libhandy/-/merge_requests/424
+  /* Unbound result rows are hidden, keep them at the end. */
+  if (entry_a == NULL || entry_b == NULL)
+    return (entry_a == NULL) - (entry_b == NULL);
+
+  /* Without fuzzy search, the results are in the order of the preferences. */
+  if (!priv->fuzzy_search)
+    return entry_a->position < entry_b->position ? -1 : entry_a->position > entry_b->position;
+
+  return compare_search_entries (entry_a, entry_b);
+}
+
+/* The displayed entries are bound to a result row taken from a pool, and give
+ * it back when they get hidden, so the result rows are only created when more
+ * of them than ever before are displayed.
+ *
+ * The CSS engine works in such a way that invisible children are treated as
+ * visible widgets, which breaks the expectations of the .preferences  style
+ * class when filtering a row, leading to straight corners when the first row
+ * or last row are filtered out.
+ *
+ * This works around it by explicitly toggling the row's visibility instead of
+ * using GtkListBox's filtering logic.
+ *
+ * See https://gitlab.gnome.org/GNOME/libhandy/-/merge_requests/424
+ */
+static void
+set_search_entry_visible (HdyPreferencesWindow *self,
+                          SearchEntry          *entry,
+                          gboolean              visible)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  GtkWidget *result;
+
+  if ((entry->result != NULL) == visible)
+    return;
+
+  if (visible) {
+    if (priv->search_result_pool->len > 0) {
+      result = g_ptr_array_remove_index_fast (priv->search_result_pool,
+                                              priv->search_result_pool->len - 1);
+      bind_search_result (result, entry);
+      gtk_list_box_row_changed (GTK_LIST_BOX_ROW (result));
+    } else {
+      result = new_search_result ();
+      bind_search_result (result, entry);
+      gtk_container_add (GTK_CONTAINER (priv->search_results), result);
+    }
+
+    gtk_widget_show (result);
+
+    return;
+  }
+
+  result = g_steal_pointer (&entry->result);
+  gtk_widget_hide (result);
+  g_object_set_data (G_OBJECT (result), "entry", NULL);
+  gtk_list_box_row_changed (GTK_LIST_BOX_ROW (result));
+  g_ptr_array_add (priv->search_result_pool, result);
+}
+
+static void
+update_search_stack (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  gtk_stack_set_visible_child_name (priv->search_stack,
+                                    priv->search_hits->len > 0 ? "results" : "no-results");
+}
+
+/* Only the rows whose visibility changes are shown or hidden, and as the keys
+ * are casefolded when indexing, only the query has to be casefolded here.
+ */
+static void
+filter_search_results (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  g_autofree gchar *query = g_utf8_casefold (gtk_entry_get_text (GTK_ENTRY (priv->search_entry)), -1);
+  guint n_hits = 0;
+
+  /* A query containing the previous one can only match a subset of what the
+   * previous one matched, e.g. when typing, so only the previous hits have to
+   * be checked again.
    */
+  if (priv->search_query != NULL && strstr (query, priv->search_query) != NULL) {
+    for (guint i = 0; i < priv->search_hits->len; i++) {
+      SearchEntry *entry = g_ptr_array_index (priv->search_hits, i);
+
+      entry->score = score_search_entry (entry, query, priv->fuzzy_search);
+
+      if (entry->score > 0)
+        priv->search_hits->pdata[n_hits++] = entry;
+      else
+        set_search_entry_visible (self, entry, FALSE);
+    }
+
+    g_ptr_array_set_size (priv->search_hits, n_hits);
+  } else {
+    g_ptr_array_set_size (priv->search_hits, 0);
 
-  if (strstr (title, text)) {
-    priv->n_last_search_results++;
-    gtk_widget_show (GTK_WIDGET (row));
+    for (guint i = 0; i < priv->search_index->len; i++) {
+      SearchEntry *entry = g_ptr_array_index (priv->search_index, i);
 
-    return TRUE;
+      entry->score = score_search_entry (entry, query, priv->fuzzy_search);
+
+      if (entry->score > 0)
+        g_ptr_array_add (priv->search_hits, entry);
+      else
+        set_search_entry_visible (self, entry, FALSE);
+    }
   }
 
-  subtitle = g_utf8_casefold (hdy_action_row_get_subtitle (row), -1);
+  if (priv->fuzzy_search)
+    g_ptr_array_sort (priv->search_hits, (GCompareFunc) compare_search_hits);
+
+  for (guint i = 0; i < priv->search_hits->len; i++)
+    set_search_entry_visible (self,
+                              g_ptr_array_index (priv->search_hits, i),
+                              priv->max_search_results == 0 || i < priv->max_search_results);
+
+  if (priv->fuzzy_search)
+    gtk_list_box_invalidate_sort (priv->search_results);
+
+  g_free (priv->search_query);
+  priv->search_query = g_steal_pointer (&query);
+}
+
+/* Returns: the position at which @entry must be in the hits, which are sorted
+ * like the results are.
+ */
+static guint
+get_search_hit_position (HdyPreferencesWindow *self,
+                         SearchEntry          *entry)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  guint start = 0, end = priv->search_hits->len;
+
+  while (start < end) {
+    guint middle = start + (end - start) / 2;
+    SearchEntry *middle_entry = g_ptr_array_index (priv->search_hits, middle);
+    gboolean before;
+
+    if (priv->fuzzy_search)
+      before = compare_search_entries (middle_entry, entry) < 0;
+    else
+      before = middle_entry->position < entry->position;
+
+    if (before)
+      start = middle + 1;
+    else
+      end = middle;
+  }
+
+  return start;
+}
+
+/* Only @entry is matched again, so retitling a row doesn't filter the whole
+ * index again.
+ */
+static void
+refilter_search_entry (HdyPreferencesWindow *self,
+                       SearchEntry          *entry)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  guint score;
 
-  if (!!strstr (subtitle, text)) {
-    priv->n_last_search_results++;
-    gtk_widget_show (GTK_WIDGET (row));
+  if (priv->search_query == NULL)
+    return;
+
+  score = score_search_entry (entry, priv->search_query, priv->fuzzy_search);
 
-    return TRUE;
+  if (score == 0 && entry->score == 0)
+    return;
+
+  for (guint i = 0; i < priv->search_hits->len; i++) {
+    if (g_ptr_array_index (priv->search_hits, i) == entry) {
+      g_ptr_array_remove_index (priv->search_hits, i);
+
+      break;
+    }
   }
 
-  gtk_widget_hide (GTK_WIDGET (row));
+  entry->score = score;
+
+  if (score > 0)
+    g_ptr_array_insert (priv->search_hits, get_search_hit_position (self, entry), entry);
+  else
+    set_search_entry_visible (self, entry, FALSE);
+
+  for (guint i = 0; i < priv->search_hits->len; i++)
+    set_search_entry_visible (self,
+                              g_ptr_array_index (priv->search_hits, i),
+                              priv->max_search_results == 0 || i < priv->max_search_results);
+
+  if (priv->fuzzy_search && entry->result != NULL)
+    gtk_list_box_row_changed (GTK_LIST_BOX_ROW (entry->result));
 
-  return FALSE;
+  update_search_stack (self);
 }
 
-static GtkWidget *
-new_search_row_for_preference (HdyPreferencesRow    *row,
-                               HdyPreferencesWindow *self)
+static void update_search_results (HdyPreferencesWindow *self);
+static void search_changed_cb (HdyPreferencesWindow *self);
+
+static void
+reset_search_filter (HdyPreferencesWindow *self)
 {
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
-  HdyActionRow *widget;
-  HdyPreferencesGroup *group;
-  HdyPreferencesPage *page;
+
+  if (priv->search_query == NULL)
+    return;
+
+  g_clear_pointer (&priv->search_query, g_free);
+  search_changed_cb (self);
+}
+
+static void
+remove_search_index_update (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  if (priv->search_index_update_id == 0)
+    return;
+
+  g_source_remove (priv->search_index_update_id);
+  priv->search_index_update_id = 0;
+}
+
+static gboolean
+update_search_index_cb (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  priv->search_index_update_id = 0;
+
+  update_search_results (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+clear_search_index (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  for (guint i = 0; i < priv->search_index->len; i++) {
+    SearchEntry *entry = g_ptr_array_index (priv->search_index, i);
+
+    set_search_entry_visible (self, entry, FALSE);
+  }
+
+  g_ptr_array_set_size (priv->search_hits, 0);
+  g_clear_pointer (&priv->search_query, g_free);
+  g_hash_table_remove_all (priv->search_entries);
+  g_ptr_array_set_size (priv->search_index, 0);
+}
+
+/* Pages, groups and rows are often added or removed in bulk, e.g. when a group
+ * is destroyed, so the index is only rebuilt once the changes are done, and
+ * only if the results are currently displayed. Otherwise it is freed right
+ * away, so it doesn't keep removed rows and pages alive, and it will be rebuilt
+ * the next time the search is opened.
+ */
+static void
+invalidate_search_index (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  priv->search_index_valid = FALSE;
+
+  if (gtk_widget_in_destruction (GTK_WIDGET (self)) ||
+      priv->search_index_update_id != 0)
+    return;
+
+  if (!gtk_toggle_button_get_active (priv->search_button)) {
+    clear_search_index (self);
+
+    return;
+  }
+
+  priv->search_index_update_id =
+    g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                     (GSourceFunc) update_search_index_cb, self, NULL);
+  g_source_set_name_by_id (priv->search_index_update_id, "[gtk+] update_search_index_cb");
+}
+
+static void
+row_title_changed_cb (HdyPreferencesWindow *self,
+                      GParamSpec           *pspec,
+                      HdyPreferencesRow    *row)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  const gchar *title = hdy_preferences_row_get_title (row);
+  SearchEntry *entry;
+
+  if (!priv->search_index_valid)
+    return;
+
+  entry = g_hash_table_lookup (priv->search_entries, row);
+
+  /* Rows without a title aren't searchable, so the row must be added to or
+   * removed from the index.
+   */
+  if ((entry != NULL) == (title == NULL || *title == '\0')) {
+    invalidate_search_index (self);
+
+    return;
+  }
+
+  if (entry == NULL)
+    return;
+
+  g_free (entry->title_key);
+  entry->title_key = g_utf8_casefold (title, -1);
+
+  if (entry->result)
+    hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (entry->result), title);
+
+  refilter_search_entry (self, entry);
+}
+
+static void
+row_use_underline_changed_cb (HdyPreferencesWindow *self,
+                              GParamSpec           *pspec,
+                              HdyPreferencesRow    *row)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  SearchEntry *entry;
+
+  if (!priv->search_index_valid)
+    return;
+
+  entry = g_hash_table_lookup (priv->search_entries, row);
+
+  if (entry == NULL || entry->result == NULL)
+    return;
+
+  hdy_preferences_row_set_use_underline (HDY_PREFERENCES_ROW (entry->result),
+                                         hdy_preferences_row_get_use_underline (row));
+}
+
+static void
+watch_search_index_source (GtkWidget            *widget,
+                           HdyPreferencesWindow *self)
+{
+  g_signal_handlers_disconnect_by_func (widget, invalidate_search_index, self);
+
+  g_signal_connect_object (widget, "notify::visible",
+                           G_CALLBACK (invalidate_search_index), self, G_CONNECT_SWAPPED);
+  g_signal_connect_object (widget, "notify::parent",
+                           G_CALLBACK (invalidate_search_index), self, G_CONNECT_SWAPPED);
+
+  if (HDY_IS_PREFERENCES_PAGE (widget) || HDY_IS_PREFERENCES_GROUP (widget))
+    g_signal_connect_object (widget, "add",
+                             G_CALLBACK (invalidate_search_index), self, G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+
+  if (HDY_IS_PREFERENCES_GROUP (widget))
+    g_signal_connect_object (widget, "notify::title",
+                             G_CALLBACK (invalidate_search_index), self, G_CONNECT_SWAPPED);
+
+  if (HDY_IS_PREFERENCES_ROW (widget)) {
+    g_signal_handlers_disconnect_by_func (widget, row_title_changed_cb, self);
+    g_signal_connect_object (widget, "notify::title",
+                             G_CALLBACK (row_title_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_handlers_disconnect_by_func (widget, row_use_underline_changed_cb, self);
+    g_signal_connect_object (widget, "notify::use-underline",
+                             G_CALLBACK (row_use_underline_changed_cb), self, G_CONNECT_SWAPPED);
+  }
+}
+
+static void
+index_row (GtkWidget *widget,
+           IndexData *data)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (data->self);
+  HdyPreferencesRow *row;
+  SearchEntry *entry;
+  const gchar *title;
+
+  if (!HDY_IS_PREFERENCES_ROW (widget))
+    return;
+
+  row = HDY_PREFERENCES_ROW (widget);
+
+  watch_search_index_source (widget, data->self);
+
+  if (!gtk_widget_get_visible (widget))
+    return;
+
+  title = hdy_preferences_row_get_title (row);
+
+  if (!title || !*title)
+    return;
+
+  entry = g_new0 (SearchEntry, 1);
+  entry->row = g_object_ref (row);
+  entry->page = g_object_ref (data->page);
+  entry->subtitle = g_strdup (data->subtitle);
+  entry->title_key = g_utf8_casefold (title, -1);
+  entry->subtitle_key = g_strdup (data->subtitle_key);
+  entry->position = priv->search_index->len;
+
+  g_ptr_array_add (priv->search_index, entry);
+  g_hash_table_insert (priv->search_entries, row, entry);
+}
+
+static void
+index_group (GtkWidget *widget,
+             IndexData *data)
+{
   const gchar *group_title, *page_title;
-  GtkWidget *parent;
+  g_autofree gchar *subtitle = NULL;
 
-  g_assert (HDY_IS_PREFERENCES_ROW (row));
+  watch_search_index_source (widget, data->self);
 
-  widget = HDY_ACTION_ROW (hdy_action_row_new ());
-  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (widget), TRUE);
-  g_object_bind_property (row, "title", widget, "title", G_BINDING_SYNC_CREATE);
-  g_object_bind_property (row, "use-underline", widget, "use-underline", G_BINDING_SYNC_CREATE);
-
-  for (parent = gtk_widget_get_parent (GTK_WIDGET (row));
-       parent != NULL && !HDY_IS_PREFERENCES_GROUP (parent);
-       parent = gtk_widget_get_parent (parent));
-  group = parent != NULL ? HDY_PREFERENCES_GROUP (parent) : NULL;
-  group_title = group != NULL ? hdy_preferences_group_get_title (group) : NULL;
+  if (!gtk_widget_get_visible (widget))
+    return;
+
+  data->group = HDY_PREFERENCES_GROUP (widget);
+
+  group_title = hdy_preferences_group_get_title (data->group);
   if (g_strcmp0 (group_title, "") == 0)
     group_title = NULL;
 
-  for (parent = gtk_widget_get_parent (GTK_WIDGET (group));
-       parent != NULL && !HDY_IS_PREFERENCES_PAGE (parent);
-       parent = gtk_widget_get_parent (parent));
-  page = parent != NULL ? HDY_PREFERENCES_PAGE (parent) : NULL;
-  page_title = page != NULL ? hdy_preferences_page_get_title (page) : NULL;
+  page_title = hdy_preferences_page_get_title (data->page);
   if (g_strcmp0 (page_title, "") == 0)
     page_title = NULL;
 
-  if (group_title && !hdy_view_switcher_title_get_title_visible (priv->view_switcher_title))
-    hdy_action_row_set_subtitle (widget, group_title);
-  if (group_title) {
-    g_autofree gchar *subtitle = g_strdup_printf ("%s → %s", page_title != NULL ? page_title : _("Untitled page"), group_title);
-    hdy_action_row_set_subtitle (widget, subtitle);
-  } else if (page_title)
-    hdy_action_row_set_subtitle (widget, page_title);
+  /* All the rows of a group share the same subtitle, so it is computed and
+   * casefolded only once per group.
+   */
+  if (group_title)
+    subtitle = g_strdup_printf ("%s → %s", page_title != NULL ? page_title : _("Untitled page"), group_title);
+  else if (page_title)
+    subtitle = g_strdup (page_title);
 
-  gtk_widget_show (GTK_WIDGET (widget));
+  data->subtitle = subtitle;
+  data->subtitle_key = g_utf8_casefold (subtitle != NULL ? subtitle : "", -1);
 
-  g_object_set_data (G_OBJECT (widget), "page", page);
-  g_object_set_data (G_OBJECT (widget), "row", row);
+  gtk_container_foreach (GTK_CONTAINER (widget), (GtkCallback) index_row, data);
 
-  return GTK_WIDGET (widget);
+  g_clear_pointer (&data->subtitle_key, g_free);
+  data->subtitle = NULL;
+  data->group = NULL;
+}
+
+static void
+index_page (GtkWidget            *widget,
+            HdyPreferencesWindow *self)
+{
+  IndexData data = { self, NULL, NULL, NULL, NULL };
+
+  watch_search_index_source (widget, self);
+
+  if (!gtk_widget_get_visible (widget))
+    return;
+
+  data.page = HDY_PREFERENCES_PAGE (widget);
+
+  gtk_container_foreach (GTK_CONTAINER (widget), (GtkCallback) index_group, &data);
+}
+
+/* Returns: %TRUE if the index had to be rebuilt */
+static gboolean
+ensure_search_index (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  if (priv->search_index_valid)
+    return FALSE;
+
+  remove_search_index_update (self);
+  clear_search_index (self);
+  gtk_container_foreach (GTK_CONTAINER (priv->pages_stack), (GtkCallback) index_page, self);
+  priv->search_index_valid = TRUE;
+
+  return TRUE;
 }
 
 static void
 update_search_results (HdyPreferencesWindow *self)
+{
+  if (ensure_search_index (self))
+    search_changed_cb (self);
+}
+
+static void
+scroll_to_row (HdyPreferencesPage *page,
+               HdyPreferencesRow  *row)
+{
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+  gint y = 0;
+
+  adjustment = hdy_preferences_page_get_vadjustment (page);
+
+  g_assert (adjustment != NULL);
+
+  if (!gtk_widget_translate_coordinates (GTK_WIDGET (row), GTK_WIDGET (page), 0, 0, NULL, &y))
+    return;
+
+  gtk_container_set_focus_child (GTK_CONTAINER (page), GTK_WIDGET (row));
+  y += gtk_adjustment_get_value (adjustment);
+  gtk_widget_get_allocation (GTK_WIDGET (row), &allocation);
+  gtk_adjustment_clamp_page (adjustment, y, y + allocation.height);
+}
+
+/* Stops waiting for the row of the last activated result to be mapped. */
+static void
+cancel_scroll_to_row (HdyPreferencesWindow *self)
 {
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
-  g_autoptr (GListStore) model;
 
-  model = g_list_store_new (HDY_TYPE_PREFERENCES_ROW);
-  gtk_container_foreach (GTK_CONTAINER (priv->pages_stack), (GtkCallback) hdy_preferences_page_add_preferences_to_model, model);
-  gtk_container_foreach (GTK_CONTAINER (priv->search_results), (GtkCallback) gtk_widget_destroy, NULL);
-  for (guint i = 0; i < g_list_model_get_n_items (G_LIST_MODEL (model)); i++)
-    gtk_container_add (GTK_CONTAINER (priv->search_results),
-                       new_search_row_for_preference ((HdyPreferencesRow *) g_list_model_get_item (G_LIST_MODEL (model), i), self));
+  if (priv->scroll_row == NULL)
+    return;
+
+  g_signal_handler_disconnect (priv->scroll_row, priv->scroll_row_map_id);
+  g_object_remove_weak_pointer (G_OBJECT (priv->scroll_row), (gpointer *) &priv->scroll_row);
+  priv->scroll_row = NULL;
+  priv->scroll_row_map_id = 0;
+}
+
+static void
+scroll_row_map_cb (HdyPreferencesWindow *self,
+                   HdyPreferencesRow    *row)
+{
+  GtkWidget *page = gtk_widget_get_ancestor (GTK_WIDGET (row), HDY_TYPE_PREFERENCES_PAGE);
+
+  cancel_scroll_to_row (self);
+
+  if (page != NULL)
+    scroll_to_row (HDY_PREFERENCES_PAGE (page), row);
 }
 
 static void
@@ -170,34 +769,39 @@ search_result_activated_cb (HdyPreferencesWindow *self,
                             HdyActionRow         *widget)
 {
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+  SearchEntry *entry;
   HdyPreferencesPage *page;
   HdyPreferencesRow *row;
-  GtkAdjustment *adjustment;
-  GtkAllocation allocation;
-  gint y = 0;
 
-  gtk_toggle_button_set_active (priv->search_button, FALSE);
-  page = HDY_PREFERENCES_PAGE (g_object_get_data (G_OBJECT (widget), "page"));
-  row = HDY_PREFERENCES_ROW (g_object_get_data (G_OBJECT (widget), "row"));
+  entry = g_object_get_data (G_OBJECT (widget), "entry");
 
-  g_assert (page != NULL);
-  g_assert (row != NULL);
+  g_assert (entry != NULL);
 
-  adjustment = hdy_preferences_page_get_vadjustment (page);
+  cancel_scroll_to_row (self);
 
-  g_assert (adjustment != NULL);
+  page = entry->page;
+  row = entry->row;
+
+  gtk_toggle_button_set_active (priv->search_button, FALSE);
 
   gtk_stack_set_visible_child (priv->pages_stack, GTK_WIDGET (page));
   gtk_widget_set_can_focus (GTK_WIDGET (row), TRUE);
   gtk_widget_grab_focus (GTK_WIDGET (row));
 
-  if (!gtk_widget_translate_coordinates (GTK_WIDGET (row), GTK_WIDGET (page), 0, 0, NULL, &y))
+  /* The row may not be mapped yet, e.g. if its group wasn't loaded by a lazy
+   * page before getting the focus, so scroll to it once it is, unless another
+   * result is activated or the search is opened again first.
+   */
+  if (gtk_widget_get_mapped (GTK_WIDGET (row))) {
+    scroll_to_row (page, row);
+
     return;
+  }
 
-  gtk_container_set_focus_child (GTK_CONTAINER (page), GTK_WIDGET (row));
-  y += gtk_adjustment_get_value (adjustment);
-  gtk_widget_get_allocation (GTK_WIDGET (row), &allocation);
-  gtk_adjustment_clamp_page (adjustment, y, y + allocation.height);
+  priv->scroll_row = row;
+  g_object_add_weak_pointer (G_OBJECT (row), (gpointer *) &priv->scroll_row);
+  priv->scroll_row_map_id =
+    g_signal_connect_swapped (row, "map", G_CALLBACK (scroll_row_map_cb), self);
 }
 
 static gboolean
@@ -304,6 +908,7 @@ search_button_notify_active_cb (HdyPreferencesWindow *self)
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
 
   if (gtk_toggle_button_get_active (priv->search_button)) {
+    cancel_scroll_to_row (self);
     update_search_results (self);
     gtk_stack_set_visible_child_name (priv->title_stack, "search");
     gtk_stack_set_visible_child_name (priv->content_stack, "search");
@@ -325,10 +930,11 @@ search_changed_cb (HdyPreferencesWindow *self)
 {
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
 
-  priv->n_last_search_results = 0;
-  gtk_list_box_invalidate_filter (priv->search_results);
-  gtk_stack_set_visible_child_name (priv->search_stack,
-                                    priv->n_last_search_results > 0 ? "results" : "no-results");
+  /* The index will be filtered once it is rebuilt. */
+  if (priv->search_index_valid)
+    filter_search_results (self);
+
+  update_search_stack (self);
 }
 
 static void
@@ -361,6 +967,35 @@ on_page_title_changed (HdyPreferencesPage   *page,
   gtk_container_child_set (GTK_CONTAINER (priv->pages_stack), GTK_WIDGET (page),
                            "title", hdy_preferences_page_get_title (page),
                            NULL);
+
+  /* The page title is part of the subtitle of its search results. */
+  invalidate_search_index (self);
+}
+
+static void
+hdy_preferences_window_dispose (GObject *object)
+{
+  HdyPreferencesWindow *self = HDY_PREFERENCES_WINDOW (object);
+
+  remove_search_index_update (self);
+  cancel_scroll_to_row (self);
+
+  G_OBJECT_CLASS (hdy_preferences_window_parent_class)->dispose (object);
+}
+
+static void
+hdy_preferences_window_finalize (GObject *object)
+{
+  HdyPreferencesWindow *self = HDY_PREFERENCES_WINDOW (object);
+  HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
+
+  g_free (priv->search_query);
+  g_ptr_array_unref (priv->search_hits);
+  g_ptr_array_unref (priv->search_result_pool);
+  g_hash_table_destroy (priv->search_entries);
+  g_ptr_array_unref (priv->search_index);
+
+  G_OBJECT_CLASS (hdy_preferences_window_parent_class)->finalize (object);
 }
 
 static void
@@ -378,6 +1013,12 @@ hdy_preferences_window_get_property (GObject    *object,
   case PROP_CAN_SWIPE_BACK:
     g_value_set_boolean (value, hdy_preferences_window_get_can_swipe_back (self));
     break;
+  case PROP_FUZZY_SEARCH:
+    g_value_set_boolean (value, hdy_preferences_window_get_fuzzy_search (self));
+    break;
+  case PROP_MAX_SEARCH_RESULTS:
+    g_value_set_uint (value, hdy_preferences_window_get_max_search_results (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -398,6 +1039,12 @@ hdy_preferences_window_set_property (GObject      *object,
   case PROP_CAN_SWIPE_BACK:
     hdy_preferences_window_set_can_swipe_back (self, g_value_get_boolean (value));
     break;
+  case PROP_FUZZY_SEARCH:
+    hdy_preferences_window_set_fuzzy_search (self, g_value_get_boolean (value));
+    break;
+  case PROP_MAX_SEARCH_RESULTS:
+    hdy_preferences_window_set_max_search_results (self, g_value_get_uint (value));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -466,6 +1113,8 @@ hdy_preferences_window_class_init (HdyPreferencesWindowClass *klass)
 
   object_class->get_property = hdy_preferences_window_get_property;
   object_class->set_property = hdy_preferences_window_set_property;
+  object_class->dispose = hdy_preferences_window_dispose;
+  object_class->finalize = hdy_preferences_window_finalize;
 
   container_class->add = hdy_preferences_window_add;
   container_class->remove = hdy_preferences_window_remove;
@@ -499,6 +1148,42 @@ hdy_preferences_window_class_init (HdyPreferencesWindowClass *klass)
                             FALSE,
                             G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * HdyPreferencesWindow:fuzzy-search:
+   *
+   * Whether the search matches the preferences fuzzily and ranks the results.
+   *
+   * When %FALSE, the results are the preferences whose title or subtitle
+   * contain the search terms, in the order of the preferences.
+   *
+   * When %TRUE, the search terms can also match the start of a word or a
+   * subsequence of the title or subtitle, and the results are ordered from
+   * the best match to the worst one.
+   *
+   * Since: 1.0
+   */
+  props[PROP_FUZZY_SEARCH] =
+      g_param_spec_boolean ("fuzzy-search",
+                            _("Fuzzy search"),
+                            _("Whether the search matches fuzzily and ranks the results"),
+                            FALSE,
+                            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * HdyPreferencesWindow:max-search-results:
+   *
+   * The maximum number of search results to display, or 0 to display all of
+   * them.
+   *
+   * Since: 1.0
+   */
+  props[PROP_MAX_SEARCH_RESULTS] =
+      g_param_spec_uint ("max-search-results",
+                         _("Maximum search results"),
+                         _("The maximum number of search results to display, or 0 for no limit"),
+                         0, G_MAXUINT, 0,
+                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   gtk_widget_class_set_template_from_resource (widget_class,
@@ -532,10 +1217,14 @@ hdy_preferences_window_init (HdyPreferencesWindow *self)
   HdyPreferencesWindowPrivate *priv = hdy_preferences_window_get_instance_private (self);
 
   priv->search_enabled = TRUE;
+  priv->search_index = g_ptr_array_new_with_free_func ((GDestroyNotify) search_entry_free);
+  priv->search_entries = g_hash_table_new (NULL, NULL);
+  priv->search_hits = g_ptr_array_new ();
+  priv->search_result_pool = g_ptr_array_new ();
 
   gtk_widget_init_template (GTK_WIDGET (self));
 
-  gtk_list_box_set_filter_func (priv->search_results, (GtkListBoxFilterFunc) filter_search_results, self, NULL);
+  gtk_list_box_set_sort_func (priv->search_results, (GtkListBoxSortFunc) sort_search_results, self, NULL);
 }
 
 /**
@@ -660,6 +1349,113 @@ hdy_preferences_window_get_can_swipe_back (HdyPreferencesWindow *self)
   return priv->can_swipe_back;
 }
 
+/**
+ * hdy_preferences_window_get_fuzzy_search:
+ * @self: a #HdyPreferencesWindow
+ *
+ * Gets whether the search of @self matches the preferences fuzzily and ranks
+ * the results.
+ *
+ * Returns: whether fuzzy search is enabled for @self.
+ *
+ * Since: 1.0
+ */
+gboolean
+hdy_preferences_window_get_fuzzy_search (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_PREFERENCES_WINDOW (self), FALSE);
+
+  priv = hdy_preferences_window_get_instance_private (self);
+
+  return priv->fuzzy_search;
+}
+
+/**
+ * hdy_preferences_window_set_fuzzy_search:
+ * @self: a #HdyPreferencesWindow
+ * @fuzzy_search: %TRUE to enable fuzzy search, %FALSE to disable it
+ *
+ * Sets whether the search of @self matches the preferences fuzzily and ranks
+ * the results, see #HdyPreferencesWindow:fuzzy-search.
+ *
+ * Since: 1.0
+ */
+void
+hdy_preferences_window_set_fuzzy_search (HdyPreferencesWindow *self,
+                                         gboolean              fuzzy_search)
+{
+  HdyPreferencesWindowPrivate *priv;
+
+  g_return_if_fail (HDY_IS_PREFERENCES_WINDOW (self));
+
+  priv = hdy_preferences_window_get_instance_private (self);
+
+  fuzzy_search = !!fuzzy_search;
+
+  if (priv->fuzzy_search == fuzzy_search)
+    return;
+
+  priv->fuzzy_search = fuzzy_search;
+  reset_search_filter (self);
+  gtk_list_box_invalidate_sort (priv->search_results);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_FUZZY_SEARCH]);
+}
+
+/**
+ * hdy_preferences_window_get_max_search_results:
+ * @self: a #HdyPreferencesWindow
+ *
+ * Gets the maximum number of search results @self displays.
+ *
+ * Returns: the maximum number of search results, or 0 if there is no limit.
+ *
+ * Since: 1.0
+ */
+guint
+hdy_preferences_window_get_max_search_results (HdyPreferencesWindow *self)
+{
+  HdyPreferencesWindowPrivate *priv;
+
+  g_return_val_if_fail (HDY_IS_PREFERENCES_WINDOW (self), 0);
+
+  priv = hdy_preferences_window_get_instance_private (self);
+
+  return priv->max_search_results;
+}
+
+/**
+ * hdy_preferences_window_set_max_search_results:
+ * @self: a #HdyPreferencesWindow
+ * @max_search_results: the maximum number of search results, or 0
+ *
+ * Sets the maximum number of search results @self displays. Only the result
+ * rows being displayed are created, so limiting their number keeps searching
+ * fast when there are many preferences.
+ *
+ * Since: 1.0
+ */
+void
+hdy_preferences_window_set_max_search_results (HdyPreferencesWindow *self,
+                                               guint                 max_search_results)
+{
+  HdyPreferencesWindowPrivate *priv;
+
+  g_return_if_fail (HDY_IS_PREFERENCES_WINDOW (self));
+
+  priv = hdy_preferences_window_get_instance_private (self);
+
+  if (priv->max_search_results == max_search_results)
+    return;
+
+  priv->max_search_results = max_search_results;
+  reset_search_filter (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_MAX_SEARCH_RESULTS]);
+}
+
 /**
  * hdy_preferences_window_present_subpage:
  * @self: a #HdyPreferencesWindow
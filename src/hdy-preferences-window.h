@@ -49,6 +49,18 @@ HDY_AVAILABLE_IN_ALL
 void     hdy_preferences_window_set_can_swipe_back (HdyPreferencesWindow *self,
                                                     gboolean              can_swipe_back);
 
+HDY_AVAILABLE_IN_ALL
+gboolean hdy_preferences_window_get_fuzzy_search (HdyPreferencesWindow *self);
+HDY_AVAILABLE_IN_ALL
+void     hdy_preferences_window_set_fuzzy_search (HdyPreferencesWindow *self,
+                                                  gboolean              fuzzy_search);
+
+HDY_AVAILABLE_IN_ALL
+guint hdy_preferences_window_get_max_search_results (HdyPreferencesWindow *self);
+HDY_AVAILABLE_IN_ALL
+void  hdy_preferences_window_set_max_search_results (HdyPreferencesWindow *self,
+                                                     guint                 max_search_results);
+
 HDY_AVAILABLE_IN_ALL
 void hdy_preferences_window_present_subpage (HdyPreferencesWindow *self,
                                              GtkWidget            *subpage);
@@ -37,6 +37,12 @@
  * Transitions between children can be animated as fades. This can be controlled
  * with hdy_squeezer_set_transition_type().
  *
+ * To avoid flickering between two children when the available size hovers
+ * around the size of one of them, e.g. while resizing a window, a larger child
+ * can be required to fit with some extra room before being picked with
+ * hdy_squeezer_set_switch_threshold(), and switching back to a larger child
+ * can be delayed with hdy_squeezer_set_switch_delay().
+ *
  * # CSS nodes
  *
  * #HdySqueezer has a single CSS node with name squeezer.
@@ -61,11 +67,13 @@ enum  {
   PROP_INTERPOLATE_SIZE,
   PROP_XALIGN,
   PROP_YALIGN,
+  PROP_SWITCH_THRESHOLD,
+  PROP_SWITCH_DELAY,
 
   /* Overridden properties */
   PROP_ORIENTATION,
 
-  LAST_PROP = PROP_YALIGN + 1,
+  LAST_PROP = PROP_SWITCH_DELAY + 1,
 };
 
 enum {
@@ -79,6 +87,16 @@ typedef struct {
   GtkWidget *widget;
   gboolean enabled;
   GtkWidget *last_focus;
+
+  /* The last size request of the child for each orientation, see
+   * get_child_size().
+   */
+  struct {
+    gboolean valid;
+    gint for_size;
+    gint minimum;
+    gint natural;
+  } size_cache[2];
 } HdySqueezerChildInfo;
 
 struct _HdySqueezer
@@ -98,8 +116,14 @@ struct _HdySqueezer
   guint transition_duration;
 
   HdySqueezerChildInfo *last_visible_child;
+  /* The surface is kept across transitions and reused as long as the size of
+   * the snapshot doesn't change, last_visible_surface_valid tells whether it
+   * currently holds a snapshot of last_visible_child.
+   */
   cairo_surface_t *last_visible_surface;
   GtkAllocation last_visible_surface_allocation;
+  gboolean last_visible_surface_valid;
+  gboolean last_visible_surface_opaque;
   guint tick_id;
   GtkProgressTracker tracker;
   gboolean first_frame_skipped;
@@ -115,6 +139,14 @@ struct _HdySqueezer
   gfloat yalign;
 
   GtkOrientation orientation;
+
+  guint switch_threshold;
+  guint switch_delay;
+  gint64 last_switch_time;
+  guint switch_timeout_id;
+
+  /* Orientations measured for their static size since the last allocation. */
+  gboolean measured_static[2];
 };
 
 static GParamSpec *props[LAST_PROP];
@@ -129,6 +161,19 @@ get_orientation (HdySqueezer *self)
   return self->orientation;
 }
 
+static void
+invalidate_child_sizes (HdySqueezer *self)
+{
+  HdySqueezerChildInfo *child_info;
+  GList *l;
+
+  for (l = self->children; l != NULL; l = l->next) {
+    child_info = l->data;
+    child_info->size_cache[GTK_ORIENTATION_HORIZONTAL].valid = FALSE;
+    child_info->size_cache[GTK_ORIENTATION_VERTICAL].valid = FALSE;
+  }
+}
+
 static void
 set_orientation (HdySqueezer    *self,
                  GtkOrientation  orientation)
@@ -137,6 +182,7 @@ set_orientation (HdySqueezer    *self,
     return;
 
   self->orientation = orientation;
+  invalidate_child_sizes (self);
   gtk_widget_queue_resize (GTK_WIDGET (self));
   g_object_notify (G_OBJECT (self), "orientation");
 }
@@ -157,6 +203,51 @@ find_child_info_for_widget (HdySqueezer *self,
   return NULL;
 }
 
+/* Measuring the children is by far the most expensive part of allocating and
+ * measuring the squeezer, so the last request of each child is cached per
+ * orientation and keyed by @for_size. The cache is invalidated by
+ * hdy_squeezer_measure() whenever the children may have changed size.
+ */
+static void
+get_child_size (HdySqueezer          *self,
+                HdySqueezerChildInfo *child_info,
+                GtkOrientation        orientation,
+                gint                  for_size,
+                gint                 *minimum,
+                gint                 *natural)
+{
+  GtkWidget *child = child_info->widget;
+  gint min, nat;
+
+  if (child_info->size_cache[orientation].valid &&
+      child_info->size_cache[orientation].for_size == for_size) {
+    min = child_info->size_cache[orientation].minimum;
+    nat = child_info->size_cache[orientation].natural;
+  } else {
+    if (orientation == GTK_ORIENTATION_VERTICAL) {
+      if (for_size < 0)
+        gtk_widget_get_preferred_height (child, &min, &nat);
+      else
+        gtk_widget_get_preferred_height_for_width (child, for_size, &min, &nat);
+    } else {
+      if (for_size < 0)
+        gtk_widget_get_preferred_width (child, &min, &nat);
+      else
+        gtk_widget_get_preferred_width_for_height (child, for_size, &min, &nat);
+    }
+
+    child_info->size_cache[orientation].valid = TRUE;
+    child_info->size_cache[orientation].for_size = for_size;
+    child_info->size_cache[orientation].minimum = min;
+    child_info->size_cache[orientation].natural = nat;
+  }
+
+  if (minimum)
+    *minimum = min;
+  if (natural)
+    *natural = nat;
+}
+
 static void
 hdy_squeezer_progress_updated (HdySqueezer *self)
 {
@@ -166,10 +257,7 @@ hdy_squeezer_progress_updated (HdySqueezer *self)
     gtk_widget_queue_resize (GTK_WIDGET (self));
 
   if (gtk_progress_tracker_get_state (&self->tracker) == GTK_PROGRESS_STATE_AFTER) {
-    if (self->last_visible_surface != NULL) {
-      cairo_surface_destroy (self->last_visible_surface);
-      self->last_visible_surface = NULL;
-    }
+    self->last_visible_surface_valid = FALSE;
 
     if (self->last_visible_child != NULL) {
       gtk_widget_set_child_visible (self->last_visible_child->widget, FALSE);
@@ -289,6 +377,8 @@ set_visible_child (HdySqueezer               *self,
   if (child_info == self->visible_child)
     return;
 
+  self->last_switch_time = g_get_monotonic_time ();
+
   toplevel = gtk_widget_get_toplevel (widget);
   if (GTK_IS_WINDOW (toplevel)) {
     focus = gtk_window_get_focus (GTK_WINDOW (toplevel));
@@ -311,9 +401,7 @@ set_visible_child (HdySqueezer               *self,
     gtk_widget_set_child_visible (self->last_visible_child->widget, FALSE);
   self->last_visible_child = NULL;
 
-  if (self->last_visible_surface != NULL)
-    cairo_surface_destroy (self->last_visible_surface);
-  self->last_visible_surface = NULL;
+  self->last_visible_surface_valid = FALSE;
 
   if (self->visible_child && self->visible_child->widget) {
     if (gtk_widget_is_visible (widget)) {
@@ -388,6 +476,8 @@ hdy_squeezer_add (GtkContainer *container,
   child_info->widget = child;
   child_info->enabled = TRUE;
   child_info->last_focus = NULL;
+  child_info->size_cache[GTK_ORIENTATION_HORIZONTAL].valid = FALSE;
+  child_info->size_cache[GTK_ORIENTATION_VERTICAL].valid = FALSE;
 
   self->children = g_list_append (self->children, child_info);
 
@@ -485,6 +575,12 @@ hdy_squeezer_get_property (GObject    *object,
   case PROP_YALIGN:
     g_value_set_float (value, hdy_squeezer_get_yalign (self));
     break;
+  case PROP_SWITCH_THRESHOLD:
+    g_value_set_uint (value, hdy_squeezer_get_switch_threshold (self));
+    break;
+  case PROP_SWITCH_DELAY:
+    g_value_set_uint (value, hdy_squeezer_get_switch_delay (self));
+    break;
   case PROP_ORIENTATION:
     g_value_set_enum (value, get_orientation (self));
     break;
@@ -521,6 +617,12 @@ hdy_squeezer_set_property (GObject      *object,
   case PROP_YALIGN:
     hdy_squeezer_set_yalign (self, g_value_get_float (value));
     break;
+  case PROP_SWITCH_THRESHOLD:
+    hdy_squeezer_set_switch_threshold (self, g_value_get_uint (value));
+    break;
+  case PROP_SWITCH_DELAY:
+    hdy_squeezer_set_switch_delay (self, g_value_get_uint (value));
+    break;
   case PROP_ORIENTATION:
     set_orientation (self, g_value_get_enum (value));
     break;
@@ -589,6 +691,10 @@ hdy_squeezer_unrealize (GtkWidget *widget)
 {
   HdySqueezer *self = HDY_SQUEEZER (widget);
 
+  /* The snapshot surface is similar to our window, so it can't outlive it. */
+  g_clear_pointer (&self->last_visible_surface, cairo_surface_destroy);
+  self->last_visible_surface_valid = FALSE;
+
   gtk_widget_unregister_window (widget, self->bin_window);
   gdk_window_destroy (self->bin_window);
   self->bin_window = NULL;
@@ -671,12 +777,115 @@ hdy_squeezer_compute_expand (GtkWidget *widget,
   *vexpand_p = vexpand;
 }
 
+static gboolean
+is_background_opaque (HdySqueezer *self)
+{
+  GtkStyleContext *context = gtk_widget_get_style_context (GTK_WIDGET (self));
+  GtkStateFlags state = gtk_style_context_get_state (context);
+  GdkRGBA *background_color = NULL;
+  gboolean opaque;
+
+  gtk_style_context_get (context, state,
+                         "background-color", &background_color,
+                         NULL);
+
+  opaque = background_color != NULL && background_color->alpha >= 1.0;
+
+  gdk_rgba_free (background_color);
+
+  return opaque;
+}
+
+static void
+snapshot_last_visible_child (HdySqueezer *self)
+{
+  GtkWidget *widget = GTK_WIDGET (self);
+  GtkAllocation allocation;
+  g_autoptr (cairo_t) pattern_cr = NULL;
+
+  gtk_widget_get_allocation (self->last_visible_child->widget, &allocation);
+
+  if (self->last_visible_surface != NULL &&
+      (allocation.width != self->last_visible_surface_allocation.width ||
+       allocation.height != self->last_visible_surface_allocation.height))
+    g_clear_pointer (&self->last_visible_surface, cairo_surface_destroy);
+
+  self->last_visible_surface_allocation = allocation;
+
+  if (self->last_visible_surface == NULL) {
+    self->last_visible_surface =
+      gdk_window_create_similar_surface (gtk_widget_get_window (widget),
+                                         CAIRO_CONTENT_COLOR_ALPHA,
+                                         allocation.width,
+                                         allocation.height);
+    pattern_cr = cairo_create (self->last_visible_surface);
+  } else {
+    pattern_cr = cairo_create (self->last_visible_surface);
+    cairo_save (pattern_cr);
+    cairo_set_operator (pattern_cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint (pattern_cr);
+    cairo_restore (pattern_cr);
+  }
+
+  /* If our background is opaque, include it in the snapshot to make it
+   * opaque too, which allows hdy_squeezer_draw_crossfade() to blend it
+   * directly with the visible child.
+   */
+  self->last_visible_surface_opaque = is_background_opaque (self);
+  if (self->last_visible_surface_opaque) {
+    gint width = gtk_widget_get_allocated_width (widget);
+    gint height = gtk_widget_get_allocated_height (widget);
+
+    gtk_render_background (gtk_widget_get_style_context (widget),
+                           pattern_cr,
+                           (allocation.width - width) * self->xalign,
+                           (allocation.height - height) * self->yalign,
+                           width, height);
+  }
+
+  /* We don't use propagate_draw here, because we don't want to apply the
+   * bin_window offset.
+   */
+  gtk_widget_draw (self->last_visible_child->widget, pattern_cr);
+
+  self->last_visible_surface_valid = TRUE;
+}
+
 static void
 hdy_squeezer_draw_crossfade (GtkWidget *widget,
                              cairo_t   *cr)
 {
   HdySqueezer *self = HDY_SQUEEZER (widget);
   gdouble progress = gtk_progress_tracker_get_progress (&self->tracker, FALSE);
+  gint width_diff = 0, height_diff = 0;
+
+  if (self->last_visible_surface_valid) {
+    width_diff = gtk_widget_get_allocated_width (widget) - self->last_visible_surface_allocation.width;
+    height_diff = gtk_widget_get_allocated_height (widget) - self->last_visible_surface_allocation.height;
+  }
+
+  /* An opaque snapshot covering the whole widget already contains the
+   * background the visible child is drawn on, so blending it over the visible
+   * child gives the same result as blending the two children in a group
+   * first, without allocating an intermediate surface on every frame.
+   */
+  if (self->last_visible_surface_valid &&
+      self->last_visible_surface_opaque &&
+      width_diff <= 0 && height_diff <= 0) {
+    gtk_container_propagate_draw (GTK_CONTAINER (self),
+                                  self->visible_child->widget,
+                                  cr);
+
+    cairo_save (cr);
+    cairo_set_source_surface (cr, self->last_visible_surface,
+                              width_diff * self->xalign,
+                              height_diff * self->yalign);
+    cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+    cairo_paint_with_alpha (cr, MAX (1.0 - progress, 0));
+    cairo_restore (cr);
+
+    return;
+  }
 
   cairo_push_group (cr);
   gtk_container_propagate_draw (GTK_CONTAINER (self),
@@ -689,10 +898,7 @@ hdy_squeezer_draw_crossfade (GtkWidget *widget,
   cairo_set_operator (cr, CAIRO_OPERATOR_DEST_IN);
   cairo_paint (cr);
 
-  if (self->last_visible_surface != NULL) {
-    gint width_diff = gtk_widget_get_allocated_width (widget) - self->last_visible_surface_allocation.width;
-    gint height_diff = gtk_widget_get_allocated_height (widget) - self->last_visible_surface_allocation.height;
-
+  if (self->last_visible_surface_valid) {
     cairo_set_source_surface (cr, self->last_visible_surface,
                               width_diff * self->xalign,
                               height_diff * self->yalign);
@@ -726,23 +932,9 @@ hdy_squeezer_draw (GtkWidget *widget,
 
   if (self->visible_child) {
     if (gtk_progress_tracker_get_state (&self->tracker) != GTK_PROGRESS_STATE_AFTER) {
-      if (self->last_visible_surface == NULL &&
-          self->last_visible_child != NULL) {
-        g_autoptr (cairo_t) pattern_cr = NULL;
-
-        gtk_widget_get_allocation (self->last_visible_child->widget,
-                                   &self->last_visible_surface_allocation);
-        self->last_visible_surface =
-          gdk_window_create_similar_surface (gtk_widget_get_window (widget),
-                                             CAIRO_CONTENT_COLOR_ALPHA,
-                                             self->last_visible_surface_allocation.width,
-                                             self->last_visible_surface_allocation.height);
-        pattern_cr = cairo_create (self->last_visible_surface);
-        /* We don't use propagate_draw here, because we don't want to apply the
-         * bin_window offset.
-         */
-        gtk_widget_draw (self->last_visible_child->widget, pattern_cr);
-      }
+      if (!self->last_visible_surface_valid &&
+          self->last_visible_child != NULL)
+        snapshot_last_visible_child (self);
 
       cairo_rectangle (cr,
                        0, 0,
@@ -769,6 +961,26 @@ hdy_squeezer_draw (GtkWidget *widget,
   return FALSE;
 }
 
+static void
+remove_switch_timeout (HdySqueezer *self)
+{
+  if (!self->switch_timeout_id)
+    return;
+
+  g_source_remove (self->switch_timeout_id);
+  self->switch_timeout_id = 0;
+}
+
+static gboolean
+switch_timeout_cb (HdySqueezer *self)
+{
+  self->switch_timeout_id = 0;
+
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+
+  return G_SOURCE_REMOVE;
+}
+
 static void
 hdy_squeezer_size_allocate (GtkWidget     *widget,
                             GtkAllocation *allocation)
@@ -777,6 +989,7 @@ hdy_squeezer_size_allocate (GtkWidget     *widget,
   HdySqueezerChildInfo *child_info = NULL;
   GtkWidget *child = NULL;
   gint child_min;
+  gboolean before_visible_child;
   GList *l;
   GtkAllocation child_allocation;
 
@@ -784,35 +997,75 @@ hdy_squeezer_size_allocate (GtkWidget     *widget,
 
   gtk_widget_set_allocation (widget, allocation);
 
+  self->measured_static[GTK_ORIENTATION_HORIZONTAL] = FALSE;
+  self->measured_static[GTK_ORIENTATION_VERTICAL] = FALSE;
+
+  /* The children are not required to be sorted by size, so we can't bisect
+   * them and we look for the first one that fits instead. Their sizes are
+   * cached, so this only measures the children that changed.
+   *
+   * Switching to a child preceding the visible one means switching to a
+   * preferred child, so such children need to fit with some extra room to be
+   * picked. This avoids flickering between two children when the available
+   * size hovers around the size of one of them.
+   */
+  before_visible_child = self->visible_child != NULL;
   for (l = self->children; l != NULL; l = l->next) {
+    gint threshold;
+
     child_info = l->data;
     child = child_info->widget;
 
+    if (child_info == self->visible_child)
+      before_visible_child = FALSE;
+
     if (!gtk_widget_get_visible (child))
       continue;
 
     if (!child_info->enabled)
       continue;
 
+    threshold = before_visible_child ? self->switch_threshold : 0;
+
     if (self->orientation == GTK_ORIENTATION_VERTICAL) {
-      if (gtk_widget_get_request_mode (child) != GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH)
-        gtk_widget_get_preferred_height (child, &child_min, NULL);
-      else
-        gtk_widget_get_preferred_height_for_width (child, allocation->width, &child_min, NULL);
+      get_child_size (self, child_info, GTK_ORIENTATION_VERTICAL,
+                      gtk_widget_get_request_mode (child) != GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH ?
+                        -1 : allocation->width,
+                      &child_min, NULL);
 
-      if (child_min <= allocation->height)
+      if (child_min + threshold <= allocation->height)
         break;
     } else {
-      if (gtk_widget_get_request_mode (child) != GTK_SIZE_REQUEST_WIDTH_FOR_HEIGHT)
-        gtk_widget_get_preferred_width (child, &child_min, NULL);
-      else
-        gtk_widget_get_preferred_width_for_height (child, allocation->height, &child_min, NULL);
+      get_child_size (self, child_info, GTK_ORIENTATION_HORIZONTAL,
+                      gtk_widget_get_request_mode (child) != GTK_SIZE_REQUEST_WIDTH_FOR_HEIGHT ?
+                        -1 : allocation->height,
+                      &child_min, NULL);
 
-      if (child_min <= allocation->width)
+      if (child_min + threshold <= allocation->width)
         break;
     }
   }
 
+  /* The visible child still fits, so switching to a preceding one can wait
+   * until it has been visible for long enough.
+   */
+  if (before_visible_child && child_info != self->visible_child &&
+      self->visible_child->enabled &&
+      gtk_widget_get_visible (self->visible_child->widget) &&
+      self->switch_delay > 0) {
+    gint64 elapsed = g_get_monotonic_time () - self->last_switch_time;
+    gint64 delay = (gint64) self->switch_delay * 1000;
+
+    if (elapsed < delay) {
+      child_info = self->visible_child;
+
+      if (self->switch_timeout_id == 0)
+        self->switch_timeout_id =
+          g_timeout_add ((delay - elapsed) / 1000 + 1,
+                         (GSourceFunc) switch_timeout_cb, self);
+    }
+  }
+
   set_visible_child (self, child_info,
                      self->transition_type,
                      self->transition_duration);
@@ -831,11 +1084,11 @@ hdy_squeezer_size_allocate (GtkWidget     *widget,
 
   if (self->last_visible_child != NULL) {
     int min, nat;
-    gtk_widget_get_preferred_width (self->last_visible_child->widget, &min, &nat);
+    get_child_size (self, self->last_visible_child, GTK_ORIENTATION_HORIZONTAL,
+                    -1, &min, &nat);
     child_allocation.width = MAX (min, allocation->width);
-    gtk_widget_get_preferred_height_for_width (self->last_visible_child->widget,
-                                               child_allocation.width,
-                                               &min, &nat);
+    get_child_size (self, self->last_visible_child, GTK_ORIENTATION_VERTICAL,
+                    child_allocation.width, &min, &nat);
     child_allocation.height = MAX (min, allocation->height);
 
     gtk_widget_size_allocate (self->last_visible_child->widget, &child_allocation);
@@ -848,9 +1101,8 @@ hdy_squeezer_size_allocate (GtkWidget     *widget,
     int min, nat;
     GtkAlign valign;
 
-    gtk_widget_get_preferred_height_for_width (self->visible_child->widget,
-                                               allocation->width,
-                                               &min, &nat);
+    get_child_size (self, self->visible_child, GTK_ORIENTATION_VERTICAL,
+                    allocation->width, &min, &nat);
     if (self->interpolate_size) {
       valign = gtk_widget_get_valign (self->visible_child->widget);
       child_allocation.height = MAX (nat, allocation->height);
@@ -887,6 +1139,24 @@ hdy_squeezer_measure (GtkWidget      *widget,
   *minimum = 0;
   *natural = 0;
 
+  /* GTK caches our size requests and always measures our static size before
+   * any contextual one after a resize has been queued on us or on one of our
+   * descendants, so this is when the cached sizes of our children may be
+   * stale. Measuring the same orientation statically twice before the next
+   * allocation means a resize has been queued in between.
+   */
+  if (for_size < 0) {
+    if ((!self->measured_static[GTK_ORIENTATION_HORIZONTAL] &&
+         !self->measured_static[GTK_ORIENTATION_VERTICAL]) ||
+        self->measured_static[orientation]) {
+      invalidate_child_sizes (self);
+      self->measured_static[GTK_ORIENTATION_HORIZONTAL] = FALSE;
+      self->measured_static[GTK_ORIENTATION_VERTICAL] = FALSE;
+    }
+
+    self->measured_static[orientation] = TRUE;
+  }
+
   for (l = self->children; l != NULL; l = l->next) {
     child_info = l->data;
     child = child_info->widget;
@@ -904,17 +1174,8 @@ hdy_squeezer_measure (GtkWidget      *widget,
      * child gets enabled/disabled.
      */
 
-    if (orientation == GTK_ORIENTATION_VERTICAL) {
-      if (for_size < 0)
-        gtk_widget_get_preferred_height (child, &child_min, &child_nat);
-      else
-        gtk_widget_get_preferred_height_for_width (child, for_size, &child_min, &child_nat);
-    } else {
-      if (for_size < 0)
-        gtk_widget_get_preferred_width (child, &child_min, &child_nat);
-      else
-        gtk_widget_get_preferred_width_for_height (child, for_size, &child_min, &child_nat);
-    }
+    get_child_size (self, child_info, orientation, for_size,
+                    &child_min, &child_nat);
 
     if (self->orientation == orientation)
       *minimum = *minimum == 0 ? child_min : MIN (*minimum, child_min);
@@ -1035,6 +1296,8 @@ hdy_squeezer_dispose (GObject *object)
 
   self->visible_child = NULL;
 
+  remove_switch_timeout (self);
+
   G_OBJECT_CLASS (hdy_squeezer_parent_class)->dispose (object);
 }
 
@@ -1173,6 +1436,42 @@ hdy_squeezer_class_init (HdySqueezerClass *klass)
                         0.5,
                         G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * HdySqueezer:switch-threshold:
+   *
+   * The extra room, in pixels, a child larger than the visible one needs in
+   * order to be picked.
+   *
+   * This avoids flickering between two children when the available size
+   * hovers around the size of one of them, e.g. while resizing a window.
+   *
+   * Since: 1.0
+   */
+  props[PROP_SWITCH_THRESHOLD] =
+    g_param_spec_uint ("switch-threshold",
+                       _("Switch threshold"),
+                       _("The extra room in pixels a larger child needs to be picked"),
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * HdySqueezer:switch-delay:
+   *
+   * The minimum time, in milliseconds, a child must have been visible for
+   * before a larger child can replace it.
+   *
+   * Switching to a smaller child when the visible one doesn't fit anymore is
+   * never delayed.
+   *
+   * Since: 1.0
+   */
+  props[PROP_SWITCH_DELAY] =
+    g_param_spec_uint ("switch-delay",
+                       _("Switch delay"),
+                       _("The minimum time in milliseconds before switching to a larger child"),
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   child_props[CHILD_PROP_ENABLED] =
@@ -1574,3 +1873,96 @@ hdy_squeezer_set_yalign (HdySqueezer *self,
   gtk_widget_queue_draw (GTK_WIDGET (self));
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_YALIGN]);
 }
+
+/**
+ * hdy_squeezer_get_switch_threshold:
+ * @self: a #HdySqueezer
+ *
+ * Gets the extra room, in pixels, a child larger than the visible one needs in
+ * order to be picked.
+ *
+ * Returns: the switch threshold, in pixels
+ *
+ * Since: 1.0
+ */
+guint
+hdy_squeezer_get_switch_threshold (HdySqueezer *self)
+{
+  g_return_val_if_fail (HDY_IS_SQUEEZER (self), 0);
+
+  return self->switch_threshold;
+}
+
+/**
+ * hdy_squeezer_set_switch_threshold:
+ * @self: a #HdySqueezer
+ * @threshold: the new threshold, in pixels
+ *
+ * Sets the extra room, in pixels, a child larger than the visible one needs in
+ * order to be picked. This avoids flickering between two children when the
+ * available size hovers around the size of one of them.
+ *
+ * Since: 1.0
+ */
+void
+hdy_squeezer_set_switch_threshold (HdySqueezer *self,
+                                   guint        threshold)
+{
+  g_return_if_fail (HDY_IS_SQUEEZER (self));
+
+  if (self->switch_threshold == threshold)
+    return;
+
+  self->switch_threshold = threshold;
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SWITCH_THRESHOLD]);
+}
+
+/**
+ * hdy_squeezer_get_switch_delay:
+ * @self: a #HdySqueezer
+ *
+ * Gets the minimum time, in milliseconds, a child must have been visible for
+ * before a larger child can replace it.
+ *
+ * Returns: the switch delay, in milliseconds
+ *
+ * Since: 1.0
+ */
+guint
+hdy_squeezer_get_switch_delay (HdySqueezer *self)
+{
+  g_return_val_if_fail (HDY_IS_SQUEEZER (self), 0);
+
+  return self->switch_delay;
+}
+
+/**
+ * hdy_squeezer_set_switch_delay:
+ * @self: a #HdySqueezer
+ * @delay: the new delay, in milliseconds
+ *
+ * Sets the minimum time, in milliseconds, a child must have been visible for
+ * before a larger child can replace it. Switching to a smaller child when the
+ * visible one doesn't fit anymore is never delayed.
+ *
+ * Since: 1.0
+ */
+void
+hdy_squeezer_set_switch_delay (HdySqueezer *self,
+                               guint        delay)
+{
+  g_return_if_fail (HDY_IS_SQUEEZER (self));
+
+  if (self->switch_delay == delay)
+    return;
+
+  self->switch_delay = delay;
+
+  if (delay == 0 && self->switch_timeout_id) {
+    remove_switch_timeout (self);
+    gtk_widget_queue_allocate (GTK_WIDGET (self));
+  }
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SWITCH_DELAY]);
+}
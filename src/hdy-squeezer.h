@@ -80,4 +80,16 @@ HDY_AVAILABLE_IN_ALL
 void   hdy_squeezer_set_yalign (HdySqueezer *self,
                                 gfloat       yalign);
 
+HDY_AVAILABLE_IN_ALL
+guint hdy_squeezer_get_switch_threshold (HdySqueezer *self);
+HDY_AVAILABLE_IN_ALL
+void  hdy_squeezer_set_switch_threshold (HdySqueezer *self,
+                                         guint        threshold);
+
+HDY_AVAILABLE_IN_ALL
+guint hdy_squeezer_get_switch_delay (HdySqueezer *self);
+HDY_AVAILABLE_IN_ALL
+void  hdy_squeezer_set_switch_delay (HdySqueezer *self,
+                                     guint        delay);
+
 G_END_DECLS
@@ -100,12 +100,11 @@ struct _HdyStackableBox
   GtkContainerClass *klass;
   gboolean can_unfold;
 
-  GList *children;
-  /* It is probably cheaper to store and maintain a reversed copy of the
-   * children list that to reverse the list every time we need to allocate or
-   * draw children for RTL languages on a horizontal widget.
+  /* Children are stored in an array so that they can be walked in either
+   * direction by index, which avoids maintaining a reversed copy for RTL
+   * languages on a horizontal widget.
    */
-  GList *children_reversed;
+  GPtrArray *children;
   HdyStackableBoxChildInfo *visible_child;
   HdyStackableBoxChildInfo *last_visible_child;
 
@@ -179,15 +178,50 @@ free_child_info (HdyStackableBoxChildInfo *child_info)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (HdyStackableBoxChildInfo, free_child_info)
 
+static inline HdyStackableBoxChildInfo *
+get_child (HdyStackableBox *self,
+           guint            index)
+{
+  return g_ptr_array_index (self->children, index);
+}
+
+static gboolean
+get_children_reversed (HdyStackableBox *self)
+{
+  return self->orientation == GTK_ORIENTATION_HORIZONTAL &&
+         gtk_widget_get_direction (GTK_WIDGET (self->container)) == GTK_TEXT_DIR_RTL;
+}
+
+static inline HdyStackableBoxChildInfo *
+get_directed_child (HdyStackableBox *self,
+                    gboolean         reversed,
+                    guint            index)
+{
+  return get_child (self, reversed ? self->children->len - index - 1 : index);
+}
+
+static gint
+find_child_index (HdyStackableBox          *self,
+                  HdyStackableBoxChildInfo *child_info)
+{
+  guint i;
+
+  for (i = 0; i < self->children->len; i++)
+    if (get_child (self, i) == child_info)
+      return i;
+
+  return -1;
+}
+
 static HdyStackableBoxChildInfo *
 find_child_info_for_widget (HdyStackableBox *self,
                             GtkWidget       *widget)
 {
-  GList *children;
   HdyStackableBoxChildInfo *child_info;
+  guint i;
 
-  for (children = self->children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_child (self, i);
 
     if (child_info->widget == widget)
       return child_info;
@@ -200,11 +234,11 @@ static HdyStackableBoxChildInfo *
 find_child_info_for_name (HdyStackableBox *self,
                           const gchar     *name)
 {
-  GList *children;
   HdyStackableBoxChildInfo *child_info;
+  guint i;
 
-  for (children = self->children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_child (self, i);
 
     if (g_strcmp0 (child_info->name, name) == 0)
       return child_info;
@@ -213,14 +247,6 @@ find_child_info_for_name (HdyStackableBox *self,
   return NULL;
 }
 
-static GList *
-get_directed_children (HdyStackableBox *self)
-{
-  return self->orientation == GTK_ORIENTATION_HORIZONTAL &&
-         gtk_widget_get_direction (GTK_WIDGET (self->container)) == GTK_TEXT_DIR_RTL ?
-         self->children_reversed : self->children;
-}
-
 static GtkPanDirection
 get_pan_direction (HdyStackableBox *self,
                    gboolean         new_child_first)
@@ -476,9 +502,9 @@ set_visible_child_info (HdyStackableBox               *self,
                         gboolean                       emit_child_switched)
 {
   GtkWidget *widget = GTK_WIDGET (self->container);
-  GList *children;
   HdyStackableBoxChildInfo *child_info;
   GtkPanDirection transition_direction = GTK_PAN_DIRECTION_LEFT;
+  guint i;
 
   /* If we are being destroyed, do not bother with transitions and
    * notifications.
@@ -488,8 +514,8 @@ set_visible_child_info (HdyStackableBox               *self,
 
   /* If none, pick first visible. */
   if (new_visible_child == NULL) {
-    for (children = self->children; children; children = children->next) {
-      child_info = children->data;
+    for (i = 0; i < self->children->len; i++) {
+      child_info = get_child (self, i);
 
       if (gtk_widget_get_visible (child_info->widget)) {
         new_visible_child = child_info;
@@ -557,13 +583,13 @@ set_visible_child_info (HdyStackableBox               *self,
     transition_duration = 0;
   else {
     gboolean new_first = FALSE;
-    for (children = self->children; children; children = children->next) {
-      if (new_visible_child == children->data) {
+    for (i = 0; i < self->children->len; i++) {
+      if (new_visible_child == get_child (self, i)) {
         new_first = TRUE;
 
         break;
       }
-      if (self->last_visible_child == children->data)
+      if (self->last_visible_child == get_child (self, i))
         break;
     }
 
@@ -583,8 +609,8 @@ set_visible_child_info (HdyStackableBox               *self,
   if (emit_child_switched) {
     gint index = 0;
 
-    for (children = self->children; children; children = children->next) {
-      child_info = children->data;
+    for (i = 0; i < self->children->len; i++) {
+      child_info = get_child (self, i);
 
       if (!child_info->navigatable)
         continue;
@@ -1195,17 +1221,17 @@ static HdyStackableBoxChildInfo *
 find_swipeable_child (HdyStackableBox        *self,
                       HdyNavigationDirection  direction)
 {
-  GList *children;
   HdyStackableBoxChildInfo *child = NULL;
+  gint i;
 
-  children = g_list_find (self->children, self->visible_child);
+  i = find_child_index (self, self->visible_child);
   do {
-    children = (direction == HDY_NAVIGATION_DIRECTION_BACK) ? children->prev : children->next;
+    i += (direction == HDY_NAVIGATION_DIRECTION_BACK) ? -1 : 1;
 
-    if (children == NULL)
+    if (i < 0 || i >= self->children->len)
       break;
 
-    child = children->data;
+    child = get_child (self, i);
   } while (child && !child->navigatable);
 
   return child;
@@ -1337,8 +1363,8 @@ hdy_stackable_box_measure (HdyStackableBox *self,
                            int             *minimum_baseline,
                            int             *natural_baseline)
 {
-  GList *children;
   HdyStackableBoxChildInfo *child_info;
+  guint i;
   gint visible_children;
   gdouble visible_child_progress;
   gint child_min, max_min, visible_min, last_visible_min;
@@ -1361,8 +1387,8 @@ hdy_stackable_box_measure (HdyStackableBox *self,
   visible_children = 0;
   child_min = max_min = visible_min = last_visible_min = 0;
   child_nat = max_nat = sum_nat = 0;
-  for (children = self->children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_child (self, i);
 
     if (child_info->widget == NULL || !gtk_widget_get_visible (child_info->widget))
       continue;
@@ -1414,8 +1440,9 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
 {
   GtkWidget *widget = GTK_WIDGET (self->container);
   GtkOrientation orientation = gtk_orientable_get_orientation (GTK_ORIENTABLE (widget));
-  GList *directed_children, *children;
   HdyStackableBoxChildInfo *child_info, *visible_child;
+  gboolean reversed;
+  guint i, n_children;
   gint start_size, end_size, visible_size;
   gint remaining_start_size, remaining_end_size, remaining_size;
   gint current_pad;
@@ -1426,14 +1453,15 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
   GtkTextDirection direction;
   gboolean under;
 
-  directed_children = get_directed_children (self);
+  reversed = get_children_reversed (self);
+  n_children = self->children->len;
   visible_child = self->visible_child;
 
   if (!visible_child)
     return;
 
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_child (self, i);
 
     if (!child_info->widget)
       continue;
@@ -1467,8 +1495,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
     /* Child transitions should be applied only when folded and when no mode
      * transition is ongoing.
      */
-    for (children = directed_children; children; children = children->next) {
-      child_info = children->data;
+    for (i = 0; i < n_children; i++) {
+      child_info = get_child (self, i);
 
       if (child_info != visible_child &&
           child_info != self->last_visible_child) {
@@ -1496,8 +1524,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
   box_homogeneous = (self->homogeneous[HDY_FOLD_UNFOLDED][GTK_ORIENTATION_HORIZONTAL] && orientation == GTK_ORIENTATION_HORIZONTAL) ||
                     (self->homogeneous[HDY_FOLD_UNFOLDED][GTK_ORIENTATION_VERTICAL] && orientation == GTK_ORIENTATION_VERTICAL);
   if (box_homogeneous) {
-    for (children = directed_children; children; children = children->next) {
-      child_info = children->data;
+    for (i = 0; i < n_children; i++) {
+      child_info = get_child (self, i);
 
       max_child_size = orientation == GTK_ORIENTATION_HORIZONTAL ?
         MAX (max_child_size, child_info->nat.width) :
@@ -1507,8 +1535,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
 
   /* Compute the start size. */
   start_size = 0;
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_directed_child (self, reversed, i);
 
     if (child_info == visible_child)
       break;
@@ -1520,8 +1548,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
 
   /* Compute the end size. */
   end_size = 0;
-  for (children = g_list_last (directed_children); children; children = children->prev) {
-    child_info = children->data;
+  for (i = n_children; i > 0; i--) {
+    child_info = get_directed_child (self, reversed, i - 1);
 
     if (child_info == visible_child)
       break;
@@ -1582,8 +1610,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
   /* Allocate starting children. */
   current_pad = start_position;
 
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_directed_child (self, reversed, i);
 
     if (child_info == visible_child)
       break;
@@ -1615,11 +1643,8 @@ hdy_stackable_box_size_allocate_folded (HdyStackableBox *self,
   /* Allocate ending children. */
   current_pad = end_position;
 
-  if (!children || !children->next)
-    return;
-
-  for (children = children->next; children; children = children->next) {
-    child_info = children->data;
+  for (i++; i < n_children; i++) {
+    child_info = get_directed_child (self, reversed, i);
 
     if (orientation == GTK_ORIENTATION_HORIZONTAL) {
       child_info->alloc.width = box_homogeneous ?
@@ -1653,8 +1678,9 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
   GtkWidget *widget = GTK_WIDGET (self->container);
   GtkOrientation orientation = gtk_orientable_get_orientation (GTK_ORIENTABLE (widget));
   GtkAllocation remaining_alloc;
-  GList *directed_children, *children;
   HdyStackableBoxChildInfo *child_info, *visible_child;
+  gboolean reversed;
+  guint i, n_children;
   gint homogeneous_size = 0, min_size, extra_size;
   gint per_child_extra, n_extra_widgets;
   gint n_visible_children, n_expand_children;
@@ -1664,15 +1690,16 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
   GtkTextDirection direction;
   gboolean under;
 
-  directed_children = get_directed_children (self);
+  reversed = get_children_reversed (self);
+  n_children = self->children->len;
   visible_child = self->visible_child;
 
   box_homogeneous = (self->homogeneous[HDY_FOLD_UNFOLDED][GTK_ORIENTATION_HORIZONTAL] && orientation == GTK_ORIENTATION_HORIZONTAL) ||
                     (self->homogeneous[HDY_FOLD_UNFOLDED][GTK_ORIENTATION_VERTICAL] && orientation == GTK_ORIENTATION_VERTICAL);
 
   n_visible_children = n_expand_children = 0;
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_child (self, i);
 
     child_info->visible = child_info->widget != NULL && gtk_widget_get_visible (child_info->widget);
 
@@ -1704,15 +1731,15 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
   else {
     min_size = 0;
     if (orientation == GTK_ORIENTATION_HORIZONTAL) {
-      for (children = directed_children; children; children = children->next) {
-        child_info = children->data;
+      for (i = 0; i < n_children; i++) {
+        child_info = get_child (self, i);
 
         min_size += child_info->nat.width;
       }
     }
     else {
-      for (children = directed_children; children; children = children->next) {
-        child_info = children->data;
+      for (i = 0; i < n_children; i++) {
+        child_info = get_child (self, i);
 
         min_size += child_info->nat.height;
       }
@@ -1735,8 +1762,8 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
   }
 
   /* Compute children allocation */
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_directed_child (self, reversed, i);
 
     if (!child_info->visible)
       continue;
@@ -1811,8 +1838,8 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
             (mode_transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_UNDER && direction == GTK_TEXT_DIR_RTL);
   else
     under = mode_transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_OVER;
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < n_children; i++) {
+    child_info = get_directed_child (self, reversed, i);
 
     if (child_info == visible_child)
       break;
@@ -1836,8 +1863,8 @@ hdy_stackable_box_size_allocate_unfolded (HdyStackableBox *self,
             (mode_transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_OVER && direction == GTK_TEXT_DIR_RTL);
   else
     under = mode_transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_UNDER;
-  for (children = g_list_last (directed_children); children; children = children->prev) {
-    child_info = children->data;
+  for (i = n_children; i > 0; i--) {
+    child_info = get_directed_child (self, reversed, i - 1);
 
     if (child_info == visible_child)
       break;
@@ -1897,7 +1924,7 @@ static void
 restack_windows (HdyStackableBox *self)
 {
   HdyStackableBoxChildInfo *child_info, *overlap_child;
-  GList *l;
+  guint i;
 
   overlap_child = get_top_overlap_child (self);
 
@@ -1906,8 +1933,8 @@ restack_windows (HdyStackableBox *self)
     // Nothing overlaps in this case
     return;
   case HDY_STACKABLE_BOX_TRANSITION_TYPE_OVER:
-    for (l = g_list_last (self->children); l; l = l->prev) {
-      child_info = l->data;
+    for (i = self->children->len; i > 0; i--) {
+      child_info = get_child (self, i - 1);
 
       if (child_info->window)
         gdk_window_raise (child_info->window);
@@ -1918,8 +1945,8 @@ restack_windows (HdyStackableBox *self)
 
     break;
   case HDY_STACKABLE_BOX_TRANSITION_TYPE_UNDER:
-    for (l = self->children; l; l = l->next) {
-      child_info = l->data;
+    for (i = 0; i < self->children->len; i++) {
+      child_info = get_child (self, i);
 
       if (child_info->window)
         gdk_window_raise (child_info->window);
@@ -1940,11 +1967,9 @@ hdy_stackable_box_size_allocate (HdyStackableBox *self,
 {
   GtkWidget *widget = GTK_WIDGET (self->container);
   GtkOrientation orientation = gtk_orientable_get_orientation (GTK_ORIENTABLE (widget));
-  GList *directed_children, *children;
   HdyStackableBoxChildInfo *child_info;
   gboolean folded;
-
-  directed_children = get_directed_children (self);
+  guint i;
 
   gtk_widget_set_allocation (widget, allocation);
 
@@ -1955,8 +1980,8 @@ hdy_stackable_box_size_allocate (HdyStackableBox *self,
   }
 
   /* Prepare children information. */
-  for (children = directed_children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_child (self, i);
 
     gtk_widget_get_preferred_size (child_info->widget, &child_info->min, &child_info->nat);
     child_info->alloc.x = child_info->alloc.y = child_info->alloc.width = child_info->alloc.height = 0;
@@ -1969,8 +1994,8 @@ hdy_stackable_box_size_allocate (HdyStackableBox *self,
 
     if (orientation == GTK_ORIENTATION_HORIZONTAL) {
 
-      for (children = directed_children; children; children = children->next) {
-        child_info = children->data;
+      for (i = 0; i < self->children->len; i++) {
+        child_info = get_child (self, i);
 
         /* FIXME Check the child is visible. */
         if (!child_info->widget)
@@ -1988,8 +2013,8 @@ hdy_stackable_box_size_allocate (HdyStackableBox *self,
       folded = visible_children > 1 && allocation->width < nat_box_size;
     }
     else {
-      for (children = directed_children; children; children = children->next) {
-        child_info = children->data;
+      for (i = 0; i < self->children->len; i++) {
+        child_info = get_child (self, i);
 
         /* FIXME Check the child is visible. */
         if (!child_info->widget)
@@ -2019,10 +2044,10 @@ hdy_stackable_box_size_allocate (HdyStackableBox *self,
     hdy_stackable_box_size_allocate_unfolded (self, allocation);
 
   /* Apply visibility and allocation. */
-  for (children = directed_children; children; children = children->next) {
+  for (i = 0; i < self->children->len; i++) {
     GtkAllocation alloc;
 
-    child_info = children->data;
+    child_info = get_child (self, i);
 
     gtk_widget_set_child_visible (child_info->widget, child_info->visible);
 
@@ -2062,8 +2087,9 @@ hdy_stackable_box_draw (HdyStackableBox *self,
                         cairo_t         *cr)
 {
   GtkWidget *widget = GTK_WIDGET (self->container);
-  GList *stacked_children, *l;
   HdyStackableBoxChildInfo *child_info, *overlap_child;
+  gboolean stacked_reversed;
+  guint i;
   gboolean is_transition;
   gboolean is_vertical;
   gboolean is_rtl;
@@ -2081,8 +2107,8 @@ hdy_stackable_box_draw (HdyStackableBox *self,
   if (!is_transition ||
       self->transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_SLIDE ||
       !overlap_child) {
-    for (l = self->children; l; l = l->next) {
-      child_info = l->data;
+    for (i = 0; i < self->children->len; i++) {
+      child_info = get_child (self, i);
 
       if (!gtk_cairo_should_draw_window (cr, child_info->window))
         continue;
@@ -2095,8 +2121,7 @@ hdy_stackable_box_draw (HdyStackableBox *self,
     return GDK_EVENT_PROPAGATE;
   }
 
-  stacked_children = self->transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_UNDER ?
-                     self->children_reversed : self->children;
+  stacked_reversed = self->transition_type == HDY_STACKABLE_BOX_TRANSITION_TYPE_UNDER;
 
   is_vertical = gtk_orientable_get_orientation (GTK_ORIENTABLE (widget)) == GTK_ORIENTATION_VERTICAL;
   is_rtl = gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL;
@@ -2162,8 +2187,8 @@ hdy_stackable_box_draw (HdyStackableBox *self,
   cairo_rectangle (cr, shadow_rect.x, shadow_rect.y, shadow_rect.width, shadow_rect.height);
   cairo_clip (cr);
 
-  for (l = stacked_children; l; l = l->next) {
-    child_info = l->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_directed_child (self, stacked_reversed, i);
 
     if (!gtk_cairo_should_draw_window (cr, child_info->window))
       continue;
@@ -2284,8 +2309,7 @@ hdy_stackable_box_add (HdyStackableBox *self,
   child_info->widget = widget;
   child_info->navigatable = TRUE;
 
-  self->children = g_list_append (self->children, child_info);
-  self->children_reversed = g_list_prepend (self->children_reversed, child_info);
+  g_ptr_array_add (self->children, child_info);
 
   if (gtk_widget_get_realized (GTK_WIDGET (self->container)))
     register_window (self, child_info);
@@ -2317,8 +2341,7 @@ hdy_stackable_box_remove (HdyStackableBox *self,
 
   g_return_if_fail (contains_child);
 
-  self->children = g_list_remove (self->children, child_info);
-  self->children_reversed = g_list_remove (self->children_reversed, child_info);
+  g_ptr_array_remove (self->children, child_info);
 
   g_signal_handlers_disconnect_by_func (widget,
                                         hdy_stackable_box_child_visibility_notify_cb,
@@ -2344,23 +2367,21 @@ hdy_stackable_box_forall (HdyStackableBox *self,
                           GtkCallback      callback,
                           gpointer         callback_data)
 {
-  /* This shallow copy is needed when the callback changes the list while we are
-   * looping through it, for example by calling hdy_stackable_box_remove() on all
-   * children when destroying the HdyStackableBox_private_offset.
-   */
-  g_autoptr (GList) children_copy = g_list_copy (self->children);
-  GList *children;
   HdyStackableBoxChildInfo *child_info;
+  guint i = 0;
 
-  for (children = children_copy; children; children = children->next) {
-    child_info = children->data;
+  /* The callback can remove the current child from the array, for example
+   * when hdy_stackable_box_remove() is called on all children when destroying
+   * the container, so only advance if the child is still in place.
+   */
+  while (i < self->children->len) {
+    child_info = get_child (self, i);
 
     (* callback) (child_info->widget, callback_data);
-  }
 
-  g_list_free (self->children_reversed);
-  self->children_reversed = g_list_copy (self->children);
-  self->children_reversed = g_list_reverse (self->children_reversed);
+    if (i < self->children->len && get_child (self, i) == child_info)
+      i++;
+  }
 }
 
 static void
@@ -2482,6 +2503,8 @@ hdy_stackable_box_finalize (GObject *object)
 
   self->visible_child = NULL;
 
+  g_clear_pointer (&self->children, g_ptr_array_unref);
+
   if (self->shadow_helper)
     g_clear_object (&self->shadow_helper);
 
@@ -2497,7 +2520,7 @@ hdy_stackable_box_realize (HdyStackableBox *self)
   GtkAllocation allocation;
   GdkWindowAttr attributes = { 0 };
   GdkWindowAttributesType attributes_mask;
-  GList *children;
+  guint i;
 
   gtk_widget_set_realized (widget, TRUE);
   gtk_widget_set_window (widget, g_object_ref (gtk_widget_get_parent_window (widget)));
@@ -2518,18 +2541,18 @@ hdy_stackable_box_realize (HdyStackableBox *self)
                                       &attributes, attributes_mask);
   gtk_widget_register_window (widget, self->view_window);
 
-  for (children = self->children; children != NULL; children = children->next)
-    register_window (self, children->data);
+  for (i = 0; i < self->children->len; i++)
+    register_window (self, get_child (self, i));
 }
 
 void
 hdy_stackable_box_unrealize (HdyStackableBox *self)
 {
   GtkWidget *widget = GTK_WIDGET (self->container);
-  GList *children;
+  guint i;
 
-  for (children = self->children; children != NULL; children = children->next)
-    unregister_window (self, children->data);
+  for (i = 0; i < self->children->len; i++)
+    unregister_window (self, get_child (self, i));
 
   gtk_widget_unregister_window (widget, self->view_window);
   gdk_window_destroy (self->view_window);
@@ -2641,19 +2664,19 @@ gdouble
 hdy_stackable_box_get_progress (HdyStackableBox *self)
 {
   gboolean new_first = FALSE;
-  GList *children;
+  guint i;
 
   if (!self->child_transition.is_gesture_active &&
       gtk_progress_tracker_get_state (&self->child_transition.tracker) == GTK_PROGRESS_STATE_AFTER)
     return 0;
 
-  for (children = self->children; children; children = children->next) {
-    if (self->last_visible_child == children->data) {
+  for (i = 0; i < self->children->len; i++) {
+    if (self->last_visible_child == get_child (self, i)) {
       new_first = TRUE;
 
       break;
     }
-    if (self->visible_child == children->data)
+    if (self->visible_child == get_child (self, i))
       break;
   }
 
@@ -2722,19 +2745,18 @@ hdy_stackable_box_switch_child (HdyStackableBox *self,
                                 gint64           duration)
 {
   HdyStackableBoxChildInfo *child_info = NULL;
-  GList *children;
-  guint i = 0;
+  guint i, j = 0;
 
-  for (children = self->children; children; children = children->next) {
-    child_info = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info = get_child (self, i);
 
     if (!child_info->navigatable)
       continue;
 
-    if (i == index)
+    if (j == index)
       break;
 
-    i++;
+    j++;
   }
 
   if (child_info == NULL) {
@@ -2858,14 +2880,14 @@ hdy_stackable_box_set_child_name (HdyStackableBox *self,
 {
   HdyStackableBoxChildInfo *child_info;
   HdyStackableBoxChildInfo *child_info2;
-  GList *children;
+  guint i;
 
   child_info = find_child_info_for_widget (self, widget);
 
   g_return_if_fail (child_info != NULL);
 
-  for (children = self->children; children; children = children->next) {
-    child_info2 = children->data;
+  for (i = 0; i < self->children->len; i++) {
+    child_info2 = get_child (self, i);
 
     if (child_info == child_info2)
       continue;
@@ -3109,8 +3131,7 @@ hdy_stackable_box_new (GtkContainer      *container,
   self->klass = klass;
   self->can_unfold = can_unfold;
 
-  self->children = NULL;
-  self->children_reversed = NULL;
+  self->children = g_ptr_array_new ();
   self->visible_child = NULL;
   self->folded = FALSE;
   self->homogeneous[HDY_FOLD_UNFOLDED][GTK_ORIENTATION_HORIZONTAL] = FALSE;
@@ -56,6 +56,13 @@ struct _HdyViewSwitcherButton
   GtkIconSize icon_size;
   gchar *label;
   GtkOrientation orientation;
+
+  /* The widths of both layouts, cached until their content or style change. */
+  gboolean sizes_valid;
+  gint h_min_width;
+  gint h_nat_width;
+  gint v_min_width;
+  gint v_nat_width;
 };
 
 static GParamSpec *props[LAST_PROP];
@@ -63,6 +70,12 @@ static GParamSpec *props[LAST_PROP];
 G_DEFINE_TYPE_WITH_CODE (HdyViewSwitcherButton, hdy_view_switcher_button, GTK_TYPE_RADIO_BUTTON,
                          G_IMPLEMENT_INTERFACE (GTK_TYPE_ORIENTABLE, NULL))
 
+static void
+invalidate_sizes (HdyViewSwitcherButton *self)
+{
+  self->sizes_valid = FALSE;
+}
+
 static void
 on_active_changed (HdyViewSwitcherButton *self)
 {
@@ -173,6 +186,16 @@ hdy_view_switcher_button_finalize (GObject *object)
   G_OBJECT_CLASS (hdy_view_switcher_button_parent_class)->finalize (object);
 }
 
+static void
+hdy_view_switcher_button_style_updated (GtkWidget *widget)
+{
+  HdyViewSwitcherButton *self = HDY_VIEW_SWITCHER_BUTTON (widget);
+
+  GTK_WIDGET_CLASS (hdy_view_switcher_button_parent_class)->style_updated (widget);
+
+  invalidate_sizes (self);
+}
+
 static void
 hdy_view_switcher_button_class_init (HdyViewSwitcherButtonClass *klass)
 {
@@ -183,6 +206,8 @@ hdy_view_switcher_button_class_init (HdyViewSwitcherButtonClass *klass)
   object_class->set_property = hdy_view_switcher_button_set_property;
   object_class->finalize = hdy_view_switcher_button_finalize;
 
+  widget_class->style_updated = hdy_view_switcher_button_style_updated;
+
   g_object_class_override_property (object_class,
                                     PROP_LABEL,
                                     "label");
@@ -331,6 +356,8 @@ hdy_view_switcher_button_set_icon_name (HdyViewSwitcherButton *self,
   g_free (self->icon_name);
   self->icon_name = g_strdup (icon_name);
 
+  invalidate_sizes (self);
+
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ICON_NAME]);
 }
 
@@ -372,6 +399,8 @@ hdy_view_switcher_button_set_icon_size (HdyViewSwitcherButton *self,
 
   self->icon_size = icon_size;
 
+  invalidate_sizes (self);
+
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_ICON_SIZE]);
 }
 
@@ -467,6 +496,8 @@ hdy_view_switcher_button_set_label (HdyViewSwitcherButton *self,
   g_free (self->label);
   self->label = g_strdup (label);
 
+  invalidate_sizes (self);
+
   g_object_notify (G_OBJECT (self), "label");
 }
 
@@ -487,8 +518,13 @@ hdy_view_switcher_button_set_narrow_ellipsize (HdyViewSwitcherButton *self,
   g_return_if_fail (HDY_IS_VIEW_SWITCHER_BUTTON (self));
   g_return_if_fail (mode >= PANGO_ELLIPSIZE_NONE && mode <= PANGO_ELLIPSIZE_END);
 
+  if (gtk_label_get_ellipsize (self->vertical_label_active) == mode)
+    return;
+
   gtk_label_set_ellipsize (self->vertical_label_active, mode);
   gtk_label_set_ellipsize (self->vertical_label_inactive, mode);
+
+  invalidate_sizes (self);
 }
 
 /**
@@ -501,6 +537,10 @@ hdy_view_switcher_button_set_narrow_ellipsize (HdyViewSwitcherButton *self,
  *
  * Measure the size requests in both horizontal and vertical modes.
  *
+ * Both layouts are measured at once, and their sizes are cached until the
+ * label, the icon or the style of @self change, so this can be used to pick a
+ * layout without measuring the button again.
+ *
  * Since: 0.0.10
  */
 void
@@ -510,27 +550,33 @@ hdy_view_switcher_button_get_size (HdyViewSwitcherButton *self,
                                    gint                  *v_min_width,
                                    gint                  *v_nat_width)
 {
-  GtkStyleContext *context;
-  GtkStateFlags state;
-  GtkBorder border;
+  g_return_if_fail (HDY_IS_VIEW_SWITCHER_BUTTON (self));
 
-  /* gtk_widget_get_preferred_width() doesn't accept both its out parameters to
-   * be NULL, so we must have guards.
-   */
-  if (h_min_width != NULL || h_nat_width != NULL)
-    gtk_widget_get_preferred_width (GTK_WIDGET (self->horizontal_box), h_min_width, h_nat_width);
-  if (v_min_width != NULL || v_nat_width != NULL)
-    gtk_widget_get_preferred_width (GTK_WIDGET (self->vertical_box), v_min_width, v_nat_width);
+  if (!self->sizes_valid) {
+    GtkStyleContext *context;
+    GtkStateFlags state;
+    GtkBorder border;
+
+    gtk_widget_get_preferred_width (GTK_WIDGET (self->horizontal_box), &self->h_min_width, &self->h_nat_width);
+    gtk_widget_get_preferred_width (GTK_WIDGET (self->vertical_box), &self->v_min_width, &self->v_nat_width);
+
+    context = gtk_widget_get_style_context (GTK_WIDGET (self));
+    state = gtk_style_context_get_state (context);
+    gtk_style_context_get_border (context, state, &border);
+    self->h_min_width += border.left + border.right;
+    self->h_nat_width += border.left + border.right;
+    self->v_min_width += border.left + border.right;
+    self->v_nat_width += border.left + border.right;
+
+    self->sizes_valid = TRUE;
+  }
 
-  context = gtk_widget_get_style_context (GTK_WIDGET (self));
-  state = gtk_style_context_get_state (context);
-  gtk_style_context_get_border (context, state, &border);
   if (h_min_width != NULL)
-    *h_min_width += border.left + border.right;
+    *h_min_width = self->h_min_width;
   if (h_nat_width != NULL)
-    *h_nat_width += border.left + border.right;
+    *h_nat_width = self->h_nat_width;
   if (v_min_width != NULL)
-    *v_min_width += border.left + border.right;
+    *v_min_width = self->v_min_width;
   if (v_nat_width != NULL)
-    *v_nat_width += border.left + border.right;
+    *v_nat_width = self->v_nat_width;
 }
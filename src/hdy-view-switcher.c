@@ -33,6 +33,10 @@
  * height. Contrary to #GtkHeaderBar, #HdyHeaderBar doesn't force a vertical
  * alignment on its title widget, so we recommend it over #GtkHeaderBar.
  *
+ * Instead of controlling a #GtkStack, the view switcher can also show the
+ * pages described by a #GListModel, see hdy_view_switcher_bind_model(). This
+ * allows applications to only create a view once it gets selected.
+ *
  * # CSS nodes
  *
  * #HdyViewSwitcher has a single CSS node with name viewswitcher.
@@ -55,6 +59,7 @@ enum {
   PROP_POLICY,
   PROP_NARROW_ELLIPSIZE,
   PROP_STACK,
+  PROP_SELECTED_INDEX,
   LAST_PROP,
 };
 
@@ -71,12 +76,67 @@ struct _HdyViewSwitcher
   HdyViewSwitcherPolicy policy;
   PangoEllipsizeMode narrow_ellipsize;
   GtkStack *stack;
+
+  /* The bound page descriptors, and their buttons in the model's order. */
+  GListModel *model;
+  GPtrArray *model_buttons;
+  gint selected_index;
+
+  /* The largest sizes of the visible buttons, cached until a button changes. */
+  gboolean button_sizes_valid;
+  gint n_visible_buttons;
+  gint max_h_min;
+  gint max_h_nat;
+  gint max_v_min;
+  gint max_v_nat;
+
+  GtkOrientation buttons_orientation;
 };
 
 static GParamSpec *props[LAST_PROP];
 
 G_DEFINE_TYPE (HdyViewSwitcher, hdy_view_switcher, GTK_TYPE_BIN)
 
+static void
+invalidate_button_sizes (HdyViewSwitcher *self)
+{
+  self->button_sizes_valid = FALSE;
+}
+
+static void
+ensure_button_sizes (HdyViewSwitcher *self)
+{
+  GHashTableIter iter;
+  gpointer button;
+
+  if (self->button_sizes_valid)
+    return;
+
+  self->n_visible_buttons = 0;
+  self->max_h_min = 0;
+  self->max_h_nat = 0;
+  self->max_v_min = 0;
+  self->max_v_nat = 0;
+
+  g_hash_table_iter_init (&iter, self->buttons);
+  while (g_hash_table_iter_next (&iter, NULL, &button)) {
+    gint h_min = 0, h_nat = 0, v_min = 0, v_nat = 0;
+
+    if (!gtk_widget_get_visible (GTK_WIDGET (button)))
+      continue;
+
+    hdy_view_switcher_button_get_size (HDY_VIEW_SWITCHER_BUTTON (button), &h_min, &h_nat, &v_min, &v_nat);
+    self->max_h_min = MAX (h_min, self->max_h_min);
+    self->max_h_nat = MAX (h_nat, self->max_h_nat);
+    self->max_v_min = MAX (v_min, self->max_v_min);
+    self->max_v_nat = MAX (v_nat, self->max_v_nat);
+
+    self->n_visible_buttons++;
+  }
+
+  self->button_sizes_valid = TRUE;
+}
+
 static void
 set_visible_stack_child_for_button (HdyViewSwitcher       *self,
                                     HdyViewSwitcherButton *button)
@@ -111,6 +171,8 @@ update_button (HdyViewSwitcher       *self,
 
   gtk_widget_set_visible (GTK_WIDGET (button),
                           gtk_widget_get_visible (widget) && (title != NULL || icon_name != NULL));
+
+  invalidate_button_sizes (self);
 }
 
 static void
@@ -221,20 +283,25 @@ static void
 add_button_for_stack_child (HdyViewSwitcher *self,
                             GtkWidget       *stack_child)
 {
-  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (self->box));
   HdyViewSwitcherButton *button = HDY_VIEW_SWITCHER_BUTTON (hdy_view_switcher_button_new ());
+  GHashTableIter iter;
+  gpointer group_button;
 
   g_object_set_data (G_OBJECT (button), "stack-child", stack_child);
   hdy_view_switcher_button_set_narrow_ellipsize (button, self->narrow_ellipsize);
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (button), self->buttons_orientation);
 
   update_button (self, stack_child, button);
 
-  if (children != NULL)
-    gtk_radio_button_join_group (GTK_RADIO_BUTTON (button), GTK_RADIO_BUTTON (children->data));
+  /* Join the group of any existing button. */
+  g_hash_table_iter_init (&iter, self->buttons);
+  if (g_hash_table_iter_next (&iter, NULL, &group_button))
+    gtk_radio_button_join_group (GTK_RADIO_BUTTON (button), GTK_RADIO_BUTTON (group_button));
 
   gtk_container_add (GTK_CONTAINER (self->box), GTK_WIDGET (button));
 
   g_signal_connect_swapped (button, "clicked", G_CALLBACK (set_visible_stack_child_for_button), self);
+  g_signal_connect_swapped (button, "style-updated", G_CALLBACK (invalidate_button_sizes), self);
   g_signal_connect (stack_child, "notify::visible", G_CALLBACK (on_stack_child_updated), self);
   g_signal_connect (stack_child, "child-notify::title", G_CALLBACK (on_stack_child_updated), self);
   g_signal_connect (stack_child, "child-notify::icon-name", G_CALLBACK (on_stack_child_updated), self);
@@ -262,6 +329,7 @@ remove_button_for_stack_child (HdyViewSwitcher *self,
   g_signal_handlers_disconnect_by_func (stack_child, on_position_updated, self);
   gtk_container_remove (GTK_CONTAINER (self->box), g_hash_table_lookup (self->buttons, stack_child));
   g_hash_table_remove (self->buttons, stack_child);
+  invalidate_button_sizes (self);
 }
 
 static void
@@ -314,6 +382,213 @@ connect_stack_signals (HdyViewSwitcher *self)
                            G_CONNECT_SWAPPED);
 }
 
+static void
+update_button_for_model_item (HdyViewSwitcher       *self,
+                              GObject               *item,
+                              HdyViewSwitcherButton *button)
+{
+  g_autofree gchar *title = NULL;
+  g_autofree gchar *icon_name = NULL;
+  gboolean needs_attention = FALSE;
+
+  g_object_get (item,
+                "title", &title,
+                "icon-name", &icon_name,
+                NULL);
+
+  /* The needs-attention property is optional. */
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (item), "needs-attention"))
+    g_object_get (item, "needs-attention", &needs_attention, NULL);
+
+  g_object_set (G_OBJECT (button),
+                "icon-name", icon_name,
+                "icon-size", GTK_ICON_SIZE_BUTTON,
+                "label", title,
+                "needs-attention", needs_attention,
+                NULL);
+
+  gtk_widget_set_visible (GTK_WIDGET (button), title != NULL || icon_name != NULL);
+
+  invalidate_button_sizes (self);
+}
+
+static void
+on_model_item_updated (GObject         *item,
+                       GParamSpec      *pspec,
+                       HdyViewSwitcher *self)
+{
+  update_button_for_model_item (self, item, g_hash_table_lookup (self->buttons, item));
+}
+
+static void
+update_active_button_for_selected_index (HdyViewSwitcher *self)
+{
+  GtkWidget *button;
+
+  if (self->selected_index < 0 || (guint) self->selected_index >= self->model_buttons->len)
+    return;
+
+  button = g_ptr_array_index (self->model_buttons, self->selected_index);
+
+  self->in_child_changed = TRUE;
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), TRUE);
+  self->in_child_changed = FALSE;
+}
+
+static void
+set_selected_index (HdyViewSwitcher *self,
+                    gint             selected_index)
+{
+  if (self->selected_index == selected_index)
+    return;
+
+  self->selected_index = selected_index;
+  update_active_button_for_selected_index (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SELECTED_INDEX]);
+}
+
+static void
+set_selected_index_for_button (HdyViewSwitcher       *self,
+                               HdyViewSwitcherButton *button)
+{
+  guint i;
+
+  /* Deactivated buttons are clicked too, ignore them. */
+  if (self->in_child_changed ||
+      !gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (button)))
+    return;
+
+  for (i = 0; i < self->model_buttons->len; i++) {
+    if (g_ptr_array_index (self->model_buttons, i) == (gpointer) button) {
+      set_selected_index (self, i);
+
+      return;
+    }
+  }
+}
+
+static void
+add_button_for_model_item (HdyViewSwitcher *self,
+                           guint            position)
+{
+  HdyViewSwitcherButton *button = HDY_VIEW_SWITCHER_BUTTON (hdy_view_switcher_button_new ());
+  g_autoptr (GObject) item = g_list_model_get_item (self->model, position);
+
+  /* The model may have dropped the item by the time its removal is notified,
+   * so the button keeps its own reference.
+   */
+  g_object_set_data_full (G_OBJECT (button), "model-item",
+                          g_object_ref (item), g_object_unref);
+  hdy_view_switcher_button_set_narrow_ellipsize (button, self->narrow_ellipsize);
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (button), self->buttons_orientation);
+
+  update_button_for_model_item (self, item, button);
+
+  /* Join the group of any existing button. */
+  if (self->model_buttons->len > 0)
+    gtk_radio_button_join_group (GTK_RADIO_BUTTON (button),
+                                 g_ptr_array_index (self->model_buttons, 0));
+
+  gtk_container_add (GTK_CONTAINER (self->box), GTK_WIDGET (button));
+  gtk_box_reorder_child (GTK_BOX (self->box), GTK_WIDGET (button), position);
+
+  g_signal_connect_swapped (button, "clicked", G_CALLBACK (set_selected_index_for_button), self);
+  g_signal_connect_swapped (button, "style-updated", G_CALLBACK (invalidate_button_sizes), self);
+  g_signal_connect (item, "notify::title", G_CALLBACK (on_model_item_updated), self);
+  g_signal_connect (item, "notify::icon-name", G_CALLBACK (on_model_item_updated), self);
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (item), "needs-attention"))
+    g_signal_connect (item, "notify::needs-attention", G_CALLBACK (on_model_item_updated), self);
+
+  g_ptr_array_insert (self->model_buttons, position, button);
+  g_hash_table_insert (self->buttons, item, button);
+}
+
+static void
+remove_button_for_model_item (HdyViewSwitcher *self,
+                              guint            position)
+{
+  GtkWidget *button = g_ptr_array_index (self->model_buttons, position);
+  GObject *item = g_object_get_data (G_OBJECT (button), "model-item");
+
+  g_signal_handlers_disconnect_by_func (item, on_model_item_updated, self);
+  g_hash_table_remove (self->buttons, item);
+  g_ptr_array_remove_index (self->model_buttons, position);
+
+  if (self->switch_button == button)
+    self->switch_button = NULL;
+
+  /* This drops the last reference to the item, so do it last. */
+  gtk_container_remove (GTK_CONTAINER (self->box), button);
+
+  invalidate_button_sizes (self);
+}
+
+static void
+model_items_changed_cb (GListModel      *model,
+                        guint            position,
+                        guint            removed,
+                        guint            added,
+                        HdyViewSwitcher *self)
+{
+  gboolean selected_removed;
+  gint new_index;
+  guint i;
+
+  selected_removed = self->selected_index >= (gint) position &&
+                     self->selected_index < (gint) (position + removed);
+
+  for (i = 0; i < removed; i++)
+    remove_button_for_model_item (self, position);
+
+  for (i = 0; i < added; i++)
+    add_button_for_model_item (self, position + i);
+
+  if (self->selected_index >= 0 && (guint) self->selected_index < position)
+    /* The selected item is in front of the change. */
+    new_index = self->selected_index;
+  else if (self->selected_index >= (gint) (position + removed))
+    /* The selected item is behind the change. */
+    new_index = self->selected_index + added - removed;
+  else
+    /* The selected item was removed, or none is selected. */
+    new_index = -1;
+
+  /* Select the first item if none is selected. */
+  if (new_index == -1 && g_list_model_get_n_items (model) > 0)
+    new_index = 0;
+
+  /* The selected page changes when the selected item is removed, even if
+   * another one ends up at the same index, so always notify then.
+   */
+  if (selected_removed) {
+    self->selected_index = new_index;
+    update_active_button_for_selected_index (self);
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SELECTED_INDEX]);
+  } else {
+    set_selected_index (self, new_index);
+
+    /* The active button may have been removed even if the index didn't change. */
+    update_active_button_for_selected_index (self);
+  }
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+unbind_model (HdyViewSwitcher *self)
+{
+  if (self->model == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_func (self->model, model_items_changed_cb, self);
+
+  while (self->model_buttons->len > 0)
+    remove_button_for_model_item (self, self->model_buttons->len - 1);
+
+  g_clear_object (&self->model);
+}
+
 static void
 hdy_view_switcher_get_property (GObject    *object,
                                 guint       prop_id,
@@ -332,6 +607,9 @@ hdy_view_switcher_get_property (GObject    *object,
   case PROP_STACK:
     g_value_set_object (value, hdy_view_switcher_get_stack (self));
     break;
+  case PROP_SELECTED_INDEX:
+    g_value_set_int (value, hdy_view_switcher_get_selected_index (self));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     break;
@@ -356,6 +634,9 @@ hdy_view_switcher_set_property (GObject      *object,
   case PROP_STACK:
     hdy_view_switcher_set_stack (self, g_value_get_object (value));
     break;
+  case PROP_SELECTED_INDEX:
+    hdy_view_switcher_set_selected_index (self, g_value_get_int (value));
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     break;
@@ -369,6 +650,7 @@ hdy_view_switcher_dispose (GObject *object)
 
   remove_switch_timer (self);
   hdy_view_switcher_set_stack (self, NULL);
+  unbind_model (self);
 
   G_OBJECT_CLASS (hdy_view_switcher_parent_class)->dispose (object);
 }
@@ -379,6 +661,7 @@ hdy_view_switcher_finalize (GObject *object)
   HdyViewSwitcher *self = HDY_VIEW_SWITCHER (object);
 
   g_hash_table_destroy (self->buttons);
+  g_ptr_array_unref (self->model_buttons);
 
   G_OBJECT_CLASS (hdy_view_switcher_parent_class)->finalize (object);
 }
@@ -389,24 +672,16 @@ hdy_view_switcher_get_preferred_width (GtkWidget *widget,
                                        gint      *nat)
 {
   HdyViewSwitcher *self = HDY_VIEW_SWITCHER (widget);
-  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (self->box));
-  gint max_h_min = 0, max_h_nat = 0, max_v_min = 0, max_v_nat = 0;
-  gint n_children = 0;
+  gint max_h_min, max_h_nat, max_v_min, max_v_nat;
+  gint n_children;
 
-  for (GList *l = children; l != NULL; l = g_list_next (l)) {
-    gint h_min = 0, h_nat = 0, v_min = 0, v_nat = 0;
+  ensure_button_sizes (self);
 
-    if (!gtk_widget_get_visible (l->data))
-      continue;
-
-    hdy_view_switcher_button_get_size (HDY_VIEW_SWITCHER_BUTTON (l->data), &h_min, &h_nat, &v_min, &v_nat);
-    max_h_min = MAX (h_min, max_h_min);
-    max_h_nat = MAX (h_nat, max_h_nat);
-    max_v_min = MAX (v_min, max_v_min);
-    max_v_nat = MAX (v_nat, max_v_nat);
-
-    n_children++;
-  }
+  max_h_min = self->max_h_min;
+  max_h_nat = self->max_h_nat;
+  max_v_min = self->max_v_min;
+  max_v_nat = self->max_v_nat;
+  n_children = self->n_visible_buttons;
 
   /* Make the buttons ask at least a minimum arbitrary size for their natural
    * width. This prevents them from looking terribly narrow in a very wide bar.
@@ -437,26 +712,15 @@ static gint
 is_narrow (HdyViewSwitcher *self,
            gint             width)
 {
-  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (self->box));
-  gint max_h_min = 0;
-  gint n_children = 0;
-
   if (self->policy == HDY_VIEW_SWITCHER_POLICY_NARROW)
     return TRUE;
 
   if (self->policy == HDY_VIEW_SWITCHER_POLICY_WIDE)
     return FALSE;
 
-  for (GList *l = children; l != NULL; l = g_list_next (l)) {
-    gint h_min = 0;
-
-    hdy_view_switcher_button_get_size (HDY_VIEW_SWITCHER_BUTTON (l->data), &h_min, NULL, NULL, NULL);
-    max_h_min = MAX (max_h_min, h_min);
+  ensure_button_sizes (self);
 
-    n_children++;
-  }
-
-  return (max_h_min * n_children) > width;
+  return (self->max_h_min * self->n_visible_buttons) > width;
 }
 
 static void
@@ -464,8 +728,6 @@ hdy_view_switcher_size_allocate (GtkWidget     *widget,
                                  GtkAllocation *allocation)
 {
   HdyViewSwitcher *self = HDY_VIEW_SWITCHER (widget);
-
-  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (self->box));
   GtkOrientation orientation;
 
   hdy_css_size_allocate (widget, allocation);
@@ -474,8 +736,19 @@ hdy_view_switcher_size_allocate (GtkWidget     *widget,
     GTK_ORIENTATION_VERTICAL :
     GTK_ORIENTATION_HORIZONTAL;
 
-  for (GList *l = children; l != NULL; l = g_list_next (l))
-    gtk_orientable_set_orientation (GTK_ORIENTABLE (l->data), orientation);
+  /* Only change the buttons' orientation when the mode changes, as it makes
+   * them relayout.
+   */
+  if (orientation != self->buttons_orientation) {
+    GHashTableIter iter;
+    gpointer button;
+
+    self->buttons_orientation = orientation;
+
+    g_hash_table_iter_init (&iter, self->buttons);
+    while (g_hash_table_iter_next (&iter, NULL, &button))
+      gtk_orientable_set_orientation (GTK_ORIENTABLE (button), orientation);
+  }
 
   GTK_WIDGET_CLASS (hdy_view_switcher_parent_class)->size_allocate (widget, allocation);
 }
@@ -546,6 +819,22 @@ hdy_view_switcher_class_init (HdyViewSwitcherClass *klass)
                          GTK_TYPE_STACK,
                          G_PARAM_EXPLICIT_NOTIFY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * HdyViewSwitcher:selected-index:
+   *
+   * The index of the selected page of the bound model, or -1 if no page is
+   * selected. See hdy_view_switcher_bind_model().
+   *
+   * Since: 1.0
+   */
+  props[PROP_SELECTED_INDEX] =
+    g_param_spec_int ("selected-index",
+                      _("Selected index"),
+                      _("The index of the selected page"),
+                      -1, G_MAXINT,
+                      -1,
+                      G_PARAM_EXPLICIT_NOTIFY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   gtk_widget_class_set_css_name (widget_class, "viewswitcher");
@@ -560,6 +849,9 @@ hdy_view_switcher_init (HdyViewSwitcher *self)
   gtk_container_add (GTK_CONTAINER (self), self->box);
 
   self->buttons = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->model_buttons = g_ptr_array_new ();
+  self->selected_index = -1;
+  self->buttons_orientation = GTK_ORIENTATION_HORIZONTAL;
 
   gtk_widget_set_valign (GTK_WIDGET (self), GTK_ALIGN_FILL);
 
@@ -673,6 +965,9 @@ hdy_view_switcher_set_narrow_ellipsize (HdyViewSwitcher    *self,
   while (g_hash_table_iter_next (&iter, NULL, &button))
     hdy_view_switcher_button_set_narrow_ellipsize (HDY_VIEW_SWITCHER_BUTTON (button), mode);
 
+  invalidate_button_sizes (self);
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_NARROW_ELLIPSIZE]);
 }
 
@@ -701,7 +996,8 @@ hdy_view_switcher_get_stack (HdyViewSwitcher *self)
  * @self: a #HdyViewSwitcher
  * @stack: (nullable): a #GtkStack
  *
- * Sets the #GtkStack to control.
+ * Sets the #GtkStack to control. This unbinds the model bound with
+ * hdy_view_switcher_bind_model(), if any.
  *
  * Since: 0.0.10
  */
@@ -715,6 +1011,9 @@ hdy_view_switcher_set_stack (HdyViewSwitcher *self,
   if (self->stack == stack)
     return;
 
+  if (stack != NULL && self->model != NULL)
+    hdy_view_switcher_bind_model (self, NULL);
+
   if (self->stack) {
     disconnect_stack_signals (self);
     gtk_container_foreach (GTK_CONTAINER (self->stack), (GtkCallback) remove_button_for_stack_child_cb, self);
@@ -732,3 +1031,125 @@ hdy_view_switcher_set_stack (HdyViewSwitcher *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PROP_STACK]);
 }
+
+/**
+ * hdy_view_switcher_get_model:
+ * @self: a #HdyViewSwitcher
+ *
+ * Gets the model bound to @self.
+ *
+ * See: hdy_view_switcher_bind_model()
+ *
+ * Returns: (nullable) (transfer none): the #GListModel, or %NULL if none is bound
+ *
+ * Since: 1.0
+ */
+GListModel *
+hdy_view_switcher_get_model (HdyViewSwitcher *self)
+{
+  g_return_val_if_fail (HDY_IS_VIEW_SWITCHER (self), NULL);
+
+  return self->model;
+}
+
+/**
+ * hdy_view_switcher_bind_model:
+ * @self: a #HdyViewSwitcher
+ * @model: (nullable): the #GListModel to be bound to @self
+ *
+ * Binds @model to @self, creating a button for each of its items. This unsets
+ * the #GtkStack controlled by @self, if any.
+ *
+ * The items of @model describe the pages: they must have the "title" and
+ * "icon-name" string properties, and can have a "needs-attention" boolean
+ * property. The buttons are updated when these properties change.
+ *
+ * Rather than switching a #GtkStack, @self then only updates its
+ * #HdyViewSwitcher:selected-index property, so applications can create the
+ * views lazily as they get selected.
+ *
+ * If @model is %NULL, @self is left empty.
+ *
+ * Since: 1.0
+ */
+void
+hdy_view_switcher_bind_model (HdyViewSwitcher *self,
+                              GListModel      *model)
+{
+  guint i, n_items;
+
+  g_return_if_fail (HDY_IS_VIEW_SWITCHER (self));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || g_type_is_a (g_list_model_get_item_type (model), G_TYPE_OBJECT));
+
+  if (self->model == model)
+    return;
+
+  if (model != NULL)
+    hdy_view_switcher_set_stack (self, NULL);
+
+  unbind_model (self);
+
+  if (model == NULL) {
+    set_selected_index (self, -1);
+    gtk_widget_queue_resize (GTK_WIDGET (self));
+
+    return;
+  }
+
+  self->model = g_object_ref (model);
+
+  n_items = g_list_model_get_n_items (model);
+  for (i = 0; i < n_items; i++)
+    add_button_for_model_item (self, i);
+
+  g_signal_connect (model, "items-changed", G_CALLBACK (model_items_changed_cb), self);
+
+  /* Select the first item, if any. The selected page changes even if the
+   * index doesn't, so always notify.
+   */
+  self->selected_index = n_items > 0 ? 0 : -1;
+  update_active_button_for_selected_index (self);
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SELECTED_INDEX]);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+/**
+ * hdy_view_switcher_get_selected_index:
+ * @self: a #HdyViewSwitcher
+ *
+ * Gets the index of the selected page of the bound model.
+ *
+ * Returns: the index of the selected page, or -1 if no page is selected
+ *
+ * Since: 1.0
+ */
+gint
+hdy_view_switcher_get_selected_index (HdyViewSwitcher *self)
+{
+  g_return_val_if_fail (HDY_IS_VIEW_SWITCHER (self), -1);
+
+  return self->selected_index;
+}
+
+/**
+ * hdy_view_switcher_set_selected_index:
+ * @self: a #HdyViewSwitcher
+ * @selected_index: the index of the page to select, or -1 to select none
+ *
+ * Selects the page at @selected_index in the bound model.
+ *
+ * Since: 1.0
+ */
+void
+hdy_view_switcher_set_selected_index (HdyViewSwitcher *self,
+                                      gint             selected_index)
+{
+  g_return_if_fail (HDY_IS_VIEW_SWITCHER (self));
+  g_return_if_fail (selected_index >= -1);
+  g_return_if_fail (selected_index == -1 ||
+                    (self->model != NULL && (guint) selected_index < g_list_model_get_n_items (self->model)));
+
+  set_selected_index (self, selected_index);
+}
@@ -49,4 +49,16 @@ HDY_AVAILABLE_IN_ALL
 void      hdy_view_switcher_set_stack (HdyViewSwitcher *self,
                                        GtkStack        *stack);
 
+HDY_AVAILABLE_IN_ALL
+GListModel *hdy_view_switcher_get_model  (HdyViewSwitcher *self);
+HDY_AVAILABLE_IN_ALL
+void        hdy_view_switcher_bind_model (HdyViewSwitcher *self,
+                                          GListModel      *model);
+
+HDY_AVAILABLE_IN_ALL
+gint hdy_view_switcher_get_selected_index (HdyViewSwitcher *self);
+HDY_AVAILABLE_IN_ALL
+void hdy_view_switcher_set_selected_index (HdyViewSwitcher *self,
+                                           gint             selected_index);
+
 G_END_DECLS
@@ -48,6 +48,7 @@ struct _HdyWindowMixin
 
   GtkStyleContext *decoration_context;
   GtkStyleContext *overlay_context;
+  gchar *window_path;
 
   GtkWidget *child;
 };
@@ -73,28 +74,73 @@ create_child_context (HdyWindowMixin *self)
   return child;
 }
 
+static GtkWidgetPath *
+get_window_path (HdyWindowMixin *self)
+{
+  GtkWidgetPath *path = gtk_widget_path_new ();
+  gint i;
+
+  gtk_widget_path_append_for_widget (path, GTK_WIDGET (self->window));
+
+  /* The state is set on the child contexts themselves, leaving it out of the
+   * path allows to change it without rebuilding the path.
+   */
+  for (i = 0; i < gtk_widget_path_length (path); i++)
+    gtk_widget_path_iter_set_state (path, i, 0);
+
+  return path;
+}
+
 static void
-update_child_context (HdyWindowMixin  *self,
-                      GtkStyleContext *context,
-                      const gchar     *name)
+update_child_context_path (GtkStyleContext     *context,
+                           const GtkWidgetPath *window_path,
+                           const gchar         *name)
 {
-  g_autoptr (GtkWidgetPath) path = gtk_widget_path_new ();
-  GtkStyleContext *parent = gtk_widget_get_style_context (GTK_WIDGET (self->window));
+  g_autoptr (GtkWidgetPath) path = gtk_widget_path_copy (window_path);
   gint position;
 
-  gtk_widget_path_append_for_widget (path, GTK_WIDGET (self->window));
   position = gtk_widget_path_append_type (path, GTK_TYPE_WIDGET);
   gtk_widget_path_iter_set_object_name (path, position, name);
 
   gtk_style_context_set_path (context, path);
-  gtk_style_context_set_state (context, gtk_style_context_get_state (parent));
+}
+
+static void
+update_child_contexts_state (HdyWindowMixin *self,
+                             gboolean        force)
+{
+  GtkStyleContext *parent = gtk_widget_get_style_context (GTK_WIDGET (self->window));
+  GtkStateFlags state = gtk_style_context_get_state (parent);
+
+  if (!force && gtk_style_context_get_state (self->decoration_context) == state)
+    return;
+
+  gtk_style_context_set_state (self->decoration_context, state);
+  gtk_style_context_set_state (self->overlay_context, state);
 }
 
 static void
 style_changed_cb (HdyWindowMixin *self)
 {
-  update_child_context (self, self->decoration_context, "decoration");
-  update_child_context (self, self->overlay_context, "decoration-overlay");
+  g_autoptr (GtkWidgetPath) path = get_window_path (self);
+  g_autofree gchar *path_string = gtk_widget_path_to_string (path);
+
+  /* Setting the path forces the contexts to be revalidated, so only do it
+   * when the window's path actually changed, e.g. when a style class such as
+   * .maximized was added to it.
+   */
+  if (g_strcmp0 (path_string, self->window_path) == 0) {
+    update_child_contexts_state (self, FALSE);
+
+    return;
+  }
+
+  g_free (self->window_path);
+  self->window_path = g_steal_pointer (&path_string);
+
+  update_child_context_path (self->decoration_context, path, "decoration");
+  update_child_context_path (self->overlay_context, path, "decoration-overlay");
+  update_child_contexts_state (self, TRUE);
 }
 
 static gboolean
@@ -102,7 +148,13 @@ window_state_event_cb (HdyWindowMixin *self,
                        GdkEvent       *event,
                        GtkWidget      *widget)
 {
-  style_changed_cb (self);
+  /* Focus changes only affect the state flags, which is a lot cheaper to
+   * update than the paths.
+   */
+  if ((event->window_state.changed_mask & ~GDK_WINDOW_STATE_FOCUSED) == 0)
+    update_child_contexts_state (self, FALSE);
+  else
+    style_changed_cb (self);
 
   return GDK_EVENT_PROPAGATE;
 }
@@ -508,6 +560,7 @@ hdy_window_mixin_finalize (GObject *object)
     g_clear_pointer (&self->masks[i], cairo_surface_destroy);
   g_clear_object (&self->decoration_context);
   g_clear_object (&self->overlay_context);
+  g_clear_pointer (&self->window_path, g_free);
 
   G_OBJECT_CLASS (hdy_window_mixin_parent_class)->finalize (object);
 }
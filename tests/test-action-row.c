@@ -29,6 +29,7 @@ test_hdy_action_row_add (void)
   g_assert_nonnull (sw);
 
   gtk_container_add (GTK_CONTAINER (row), sw);
+  g_assert_true (gtk_widget_is_ancestor (sw, GTK_WIDGET (row)));
 }
 
 
@@ -45,6 +46,9 @@ test_hdy_action_row_add_prefix (void)
   g_assert_nonnull (radio);
 
   hdy_action_row_add_prefix (row, radio);
+  g_assert_true (gtk_widget_is_ancestor (radio, GTK_WIDGET (row)));
+
+  gtk_container_remove (GTK_CONTAINER (row), radio);
 }
 
 
@@ -60,6 +64,9 @@ test_hdy_action_row_subtitle (void)
 
   hdy_action_row_set_subtitle (row, "Dummy subtitle");
   g_assert_cmpstr (hdy_action_row_get_subtitle (row), ==, "Dummy subtitle");
+
+  hdy_action_row_set_subtitle (row, NULL);
+  g_assert_cmpstr (hdy_action_row_get_subtitle (row), ==, "");
 }
 
 
@@ -75,6 +82,9 @@ test_hdy_action_row_icon_name (void)
 
   hdy_action_row_set_icon_name (row, "dummy-icon-name");
   g_assert_cmpstr (hdy_action_row_get_icon_name (row), ==, "dummy-icon-name");
+
+  hdy_action_row_set_icon_name (row, NULL);
+  g_assert_null (hdy_action_row_get_icon_name (row));
 }
 
 
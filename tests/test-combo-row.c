@@ -7,6 +7,86 @@
 #define HANDY_USE_UNSTABLE_API
 #include <handy.h>
 
+#include "test-utils.h"
+
+
+#define N_LARGE_MODEL_ITEMS 10000
+
+
+static gchar *
+get_item_name (HdyValueObject *item,
+               gpointer        user_data)
+{
+  return g_strdup (hdy_value_object_get_string (item));
+}
+
+
+static GtkWidget *
+create_large_model_row (GListStore **store)
+{
+  GtkWidget *window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  GtkWidget *list = gtk_list_box_new ();
+  GtkWidget *row = hdy_combo_row_new ();
+  guint i;
+
+  *store = g_list_store_new (HDY_TYPE_VALUE_OBJECT);
+  for (i = 0; i < N_LARGE_MODEL_ITEMS; i++) {
+    g_autoptr (HdyValueObject) value = hdy_value_object_new_take_string (g_strdup_printf ("Item %u", i));
+
+    g_list_store_append (*store, value);
+  }
+
+  hdy_combo_row_bind_name_model (HDY_COMBO_ROW (row), G_LIST_MODEL (*store),
+                                 (HdyComboRowGetNameFunc) get_item_name, NULL, NULL);
+  hdy_combo_row_set_virtual_list (HDY_COMBO_ROW (row), TRUE);
+
+  gtk_container_add (GTK_CONTAINER (list), row);
+  gtk_container_add (GTK_CONTAINER (window), list);
+  gtk_widget_show_all (window);
+
+  return row;
+}
+
+
+static GtkWidget *
+find_label (GtkWidget *widget)
+{
+  g_autoptr (GList) children = NULL;
+  GList *l;
+
+  if (GTK_IS_LABEL (widget))
+    return widget;
+
+  if (!GTK_IS_CONTAINER (widget))
+    return NULL;
+
+  children = gtk_container_get_children (GTK_CONTAINER (widget));
+  for (l = children; l; l = l->next) {
+    GtkWidget *label = find_label (l->data);
+
+    if (label)
+      return label;
+  }
+
+  return NULL;
+}
+
+
+/* Returns the names of the rows shown in the popover, in their order. */
+static GPtrArray *
+get_shown_names (GtkWidget *row)
+{
+  g_autoptr (GList) children = NULL;
+  GPtrArray *names = g_ptr_array_new ();
+  GList *l;
+
+  children = gtk_container_get_children (GTK_CONTAINER (test_find_internal_child (row, "list")));
+  for (l = children; l; l = l->next)
+    if (gtk_widget_get_visible (l->data))
+      g_ptr_array_add (names, (gpointer) gtk_label_get_label (GTK_LABEL (find_label (l->data))));
+
+  return names;
+}
 
 static void
 test_hdy_combo_row_set_for_enum (void)
@@ -54,6 +134,156 @@ test_hdy_combo_row_use_subtitle (void)
 }
 
 
+static void
+test_hdy_combo_row_selected_index (void)
+{
+  g_autoptr (HdyComboRow) row = NULL;
+  g_autoptr (GListStore) store = NULL;
+  GEnumClass *enum_class;
+
+  row = g_object_ref_sink (HDY_COMBO_ROW (hdy_combo_row_new ()));
+  g_assert_nonnull (row);
+
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, -1);
+
+  enum_class = g_type_class_ref (GTK_TYPE_POSITION_TYPE);
+  store = g_list_store_new (HDY_TYPE_ENUM_VALUE_OBJECT);
+  for (guint i = 0; i < enum_class->n_values; i++) {
+    g_autoptr (HdyEnumValueObject) value = hdy_enum_value_object_new (&enum_class->values[i]);
+
+    g_list_store_append (store, value);
+  }
+  g_type_class_unref (enum_class);
+
+  hdy_combo_row_bind_name_model (row, G_LIST_MODEL (store), (HdyComboRowGetNameFunc) hdy_enum_value_row_name, NULL, NULL);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 0);
+
+  hdy_combo_row_set_selected_index (row, 2);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 2);
+
+  /* Removing an item before the selected one moves the selection. */
+  g_list_store_remove (store, 0);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 1);
+
+  /* Removing the selected item selects the first one. */
+  g_list_store_remove (store, 1);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 0);
+
+  g_list_store_remove_all (store);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, -1);
+
+  hdy_combo_row_bind_name_model (row, NULL, NULL, NULL, NULL);
+  g_assert_null (hdy_combo_row_get_model (row));
+}
+
+
+static void
+test_hdy_combo_row_virtual_list (void)
+{
+  g_autoptr (HdyComboRow) row = NULL;
+
+  row = g_object_ref_sink (HDY_COMBO_ROW (hdy_combo_row_new ()));
+  g_assert_nonnull (row);
+
+  g_assert_false (hdy_combo_row_get_virtual_list (row));
+
+  hdy_combo_row_set_for_enum (row, GTK_TYPE_POSITION_TYPE, hdy_enum_value_row_name, NULL, NULL);
+
+  hdy_combo_row_set_virtual_list (row, TRUE);
+  g_assert_true (hdy_combo_row_get_virtual_list (row));
+
+  hdy_combo_row_set_selected_index (row, 3);
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 3);
+
+  hdy_combo_row_set_virtual_list (row, FALSE);
+  g_assert_false (hdy_combo_row_get_virtual_list (row));
+  g_assert_cmpint (hdy_combo_row_get_selected_index (row), ==, 3);
+}
+
+
+static void
+test_hdy_combo_row_filter_enabled (void)
+{
+  g_autoptr (HdyComboRow) row = NULL;
+
+  row = g_object_ref_sink (HDY_COMBO_ROW (hdy_combo_row_new ()));
+  g_assert_nonnull (row);
+
+  g_assert_false (hdy_combo_row_get_filter_enabled (row));
+
+  hdy_combo_row_set_filter_enabled (row, TRUE);
+  g_assert_true (hdy_combo_row_get_filter_enabled (row));
+
+  hdy_combo_row_set_filter_enabled (row, FALSE);
+  g_assert_false (hdy_combo_row_get_filter_enabled (row));
+}
+
+
+static void
+test_hdy_combo_row_virtual_list_rows (void)
+{
+  g_autoptr (GListStore) store = NULL;
+  g_autoptr (GPtrArray) names = NULL;
+  GtkWidget *row = create_large_model_row (&store);
+
+  hdy_action_row_activate (HDY_ACTION_ROW (row));
+
+  /* Only the rows around the visible ones are created. */
+  names = get_shown_names (row);
+  g_assert_cmpuint (names->len, >, 0);
+  g_assert_cmpuint (names->len, <, 100);
+  g_assert_cmpstr (g_ptr_array_index (names, 0), ==, "Item 0");
+  g_assert_cmpstr (g_ptr_array_index (names, 1), ==, "Item 1");
+
+  gtk_widget_destroy (gtk_widget_get_toplevel (row));
+}
+
+
+static void
+test_hdy_combo_row_filter (void)
+{
+  g_autoptr (GListStore) store = NULL;
+  g_autoptr (GPtrArray) names = NULL;
+  GtkWidget *row = create_large_model_row (&store);
+  GtkWidget *entry;
+  guint i;
+
+  hdy_combo_row_set_filter_enabled (HDY_COMBO_ROW (row), TRUE);
+  hdy_action_row_activate (HDY_ACTION_ROW (row));
+
+  entry = test_find_internal_child (row, "filter_entry");
+  gtk_entry_set_text (GTK_ENTRY (entry), "ITEM 999");
+  /* Don't wait for the search entry's delay. */
+  g_signal_emit_by_name (entry, "search-changed");
+
+  names = get_shown_names (row);
+  g_assert_cmpuint (names->len, ==, 11);
+  g_assert_cmpstr (g_ptr_array_index (names, 0), ==, "Item 999");
+  for (i = 1; i < 11; i++) {
+    g_autofree gchar *name = g_strdup_printf ("Item %u", 9989 + i);
+
+    g_assert_cmpstr (g_ptr_array_index (names, i), ==, name);
+  }
+
+  /* Activating the entry selects the first match. */
+  g_signal_emit_by_name (entry, "activate");
+  g_assert_cmpint (hdy_combo_row_get_selected_index (HDY_COMBO_ROW (row)), ==, 999);
+
+  /* Nothing is selected when nothing matches. */
+  hdy_action_row_activate (HDY_ACTION_ROW (row));
+  gtk_entry_set_text (GTK_ENTRY (entry), "nothing");
+  g_signal_emit_by_name (entry, "search-changed");
+  g_clear_pointer (&names, g_ptr_array_unref);
+  names = get_shown_names (row);
+  g_assert_cmpuint (names->len, ==, 0);
+
+  g_signal_emit_by_name (entry, "activate");
+  g_assert_cmpint (hdy_combo_row_get_selected_index (HDY_COMBO_ROW (row)), ==, 999);
+
+  gtk_widget_destroy (gtk_widget_get_toplevel (row));
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -63,6 +293,11 @@ main (gint argc,
 
   g_test_add_func("/Handy/ComboRow/set_for_enum", test_hdy_combo_row_set_for_enum);
   g_test_add_func("/Handy/ComboRow/use_subtitle", test_hdy_combo_row_use_subtitle);
+  g_test_add_func("/Handy/ComboRow/selected_index", test_hdy_combo_row_selected_index);
+  g_test_add_func("/Handy/ComboRow/virtual_list", test_hdy_combo_row_virtual_list);
+  g_test_add_func("/Handy/ComboRow/filter_enabled", test_hdy_combo_row_filter_enabled);
+  g_test_add_func("/Handy/ComboRow/virtual_list_rows", test_hdy_combo_row_virtual_list_rows);
+  g_test_add_func("/Handy/ComboRow/filter", test_hdy_combo_row_filter);
 
   return g_test_run();
 }
@@ -135,6 +135,74 @@ test_hdy_expander_row_show_enable_switch (void)
 }
 
 
+static GtkWidget *
+create_row_cb (gpointer  item,
+               gint     *n_created)
+{
+  (*n_created)++;
+
+  return hdy_action_row_new ();
+}
+
+
+static guint
+count_children (HdyExpanderRow *row)
+{
+  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (row));
+
+  return g_list_length (children);
+}
+
+
+static void
+test_hdy_expander_row_bind_model (void)
+{
+  g_autoptr (HdyExpanderRow) row = NULL;
+  g_autoptr (GListStore) store = NULL;
+  g_autoptr (HdyValueObject) obj = NULL;
+  gint n_created = 0;
+  gint i;
+
+  row = g_object_ref_sink (HDY_EXPANDER_ROW (hdy_expander_row_new ()));
+  g_assert_nonnull (row);
+
+  store = g_list_store_new (HDY_TYPE_VALUE_OBJECT);
+  for (i = 0; i < 3; i++) {
+    g_autoptr (HdyValueObject) item = hdy_value_object_new_string ("Item");
+
+    g_list_store_append (store, item);
+  }
+
+  hdy_expander_row_bind_model (row, G_LIST_MODEL (store), (GtkListBoxCreateWidgetFunc) create_row_cb, &n_created, NULL);
+  g_assert_cmpint (n_created, ==, 0);
+  g_assert_cmpuint (count_children (row), ==, 0);
+
+  hdy_expander_row_set_expanded (row, TRUE);
+  g_assert_cmpint (n_created, ==, 3);
+  g_assert_cmpuint (count_children (row), ==, 3);
+
+  hdy_expander_row_set_expanded (row, FALSE);
+  g_assert_cmpuint (count_children (row), ==, 3);
+
+  g_assert_false (hdy_expander_row_get_discard_on_collapse (row));
+  hdy_expander_row_set_discard_on_collapse (row, TRUE);
+  g_assert_true (hdy_expander_row_get_discard_on_collapse (row));
+  g_assert_cmpuint (count_children (row), ==, 0);
+
+  hdy_expander_row_set_expanded (row, TRUE);
+  g_assert_cmpint (n_created, ==, 6);
+  g_assert_cmpuint (count_children (row), ==, 3);
+
+  obj = hdy_value_object_new_string ("Item");
+  g_list_store_append (store, obj);
+  g_assert_cmpint (n_created, ==, 7);
+  g_assert_cmpuint (count_children (row), ==, 4);
+
+  hdy_expander_row_bind_model (row, NULL, NULL, NULL, NULL);
+  g_assert_cmpuint (count_children (row), ==, 0);
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -149,6 +217,7 @@ main (gint argc,
   g_test_add_func("/Handy/ExpanderRow/expanded", test_hdy_expander_row_expanded);
   g_test_add_func("/Handy/ExpanderRow/enable_expansion", test_hdy_expander_row_enable_expansion);
   g_test_add_func("/Handy/ExpanderRow/show_enable_switch", test_hdy_expander_row_show_enable_switch);
+  g_test_add_func("/Handy/ExpanderRow/bind_model", test_hdy_expander_row_bind_model);
 
   return g_test_run();
 }
@@ -56,6 +56,43 @@ test_hdy_header_group_add_remove (void)
 }
 
 
+static void
+test_hdy_header_group_decoration_layouts (void)
+{
+  g_autoptr (HdyHeaderGroup) hg = HDY_HEADER_GROUP (hdy_header_group_new ());
+  g_autoptr (HdyHeaderBar) bar1 = HDY_HEADER_BAR (g_object_ref_sink (hdy_header_bar_new ()));
+  g_autoptr (GtkHeaderBar) bar2 = GTK_HEADER_BAR (g_object_ref_sink (gtk_header_bar_new ()));
+  g_autofree gchar *layout = NULL;
+
+  g_object_get (gtk_settings_get_default (), "gtk-decoration-layout", &layout, NULL);
+  if (layout == NULL)
+    layout = g_strdup (":");
+
+  hdy_header_group_add_header_bar (hg, bar1);
+  hdy_header_group_add_gtk_header_bar (hg, bar2);
+
+  /* The layouts are updated asynchronously. */
+  g_assert_null (hdy_header_bar_get_decoration_layout (bar1));
+  g_assert_null (gtk_header_bar_get_decoration_layout (bar2));
+
+  while (g_main_context_iteration (NULL, FALSE));
+
+  /* Unmapped header bars get no decorations. */
+  g_assert_cmpstr (hdy_header_bar_get_decoration_layout (bar1), ==, ":");
+  g_assert_cmpstr (gtk_header_bar_get_decoration_layout (bar2), ==, ":");
+
+  hdy_header_group_set_decorate_all (hg, TRUE);
+
+  while (g_main_context_iteration (NULL, FALSE));
+
+  g_assert_cmpstr (hdy_header_bar_get_decoration_layout (bar1), ==, layout);
+  g_assert_cmpstr (gtk_header_bar_get_decoration_layout (bar2), ==, layout);
+
+  hdy_header_group_remove_gtk_header_bar (hg, bar2);
+  hdy_header_group_remove_header_bar (hg, bar1);
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -65,5 +102,6 @@ main (gint argc,
 
   g_test_add_func("/Handy/HeaderGroup/decorate_all", test_hdy_header_group_decorate_all);
   g_test_add_func("/Handy/HeaderGroup/add_remove", test_hdy_header_group_add_remove);
+  g_test_add_func("/Handy/HeaderGroup/decoration_layouts", test_hdy_header_group_decoration_layouts);
   return g_test_run();
 }
@@ -228,6 +228,38 @@ test_hdy_keypad_end_action (void)
 }
 
 
+static void
+test_hdy_keypad_insert (void)
+{
+  g_autoptr (HdyKeypad) keypad = NULL;
+  g_autoptr (GtkEntry) entry = NULL;
+  gint position = 0;
+
+  keypad = g_object_ref_sink (HDY_KEYPAD (hdy_keypad_new (TRUE, TRUE)));
+  entry = g_object_ref_sink (GTK_ENTRY (gtk_entry_new ()));
+
+  /* Inserting without an entry does nothing. */
+  hdy_keypad_insert (keypad, "123");
+
+  hdy_keypad_set_entry (keypad, entry);
+
+  hdy_keypad_insert (keypad, "0123456789");
+  g_assert_cmpstr (gtk_entry_get_text (entry), ==, "0123456789");
+
+  gtk_entry_set_text (entry, "");
+  hdy_keypad_insert (keypad, "1a2 3-4\xc3\xa95");
+  g_assert_cmpstr (gtk_entry_get_text (entry), ==, "12345");
+
+  gtk_entry_set_text (entry, "");
+  hdy_keypad_insert (keypad, "abc");
+  g_assert_cmpstr (gtk_entry_get_text (entry), ==, "");
+
+  /* Typed and pasted text is filtered too. */
+  gtk_editable_insert_text (GTK_EDITABLE (entry), "5x6", -1, &position);
+  g_assert_cmpstr (gtk_entry_get_text (entry), ==, "56");
+  g_assert_cmpint (position, ==, 2);
+}
+
 
 gint
 main (gint argc,
@@ -243,6 +275,7 @@ main (gint argc,
   g_test_add_func ("/Handy/Keypad/entry", test_hdy_keypad_entry);
   g_test_add_func ("/Handy/Keypad/start_action", test_hdy_keypad_start_action);
   g_test_add_func ("/Handy/Keypad/end_action", test_hdy_keypad_end_action);
+  g_test_add_func ("/Handy/Keypad/insert", test_hdy_keypad_insert);
 
   return g_test_run ();
 }
@@ -66,6 +66,108 @@ test_hdy_preferences_page_icon_name (void)
 }
 
 
+#define N_LAZY_GROUPS 30
+#define N_LAZY_ROWS 5
+
+
+static void
+run_layout (GtkWidget *window)
+{
+  gint i;
+
+  /* Loading groups queues a new resize, so give it a few passes. */
+  for (i = 0; i < 5; i++) {
+    gtk_container_check_resize (GTK_CONTAINER (window));
+
+    while (gtk_events_pending ())
+      gtk_main_iteration ();
+  }
+}
+
+
+static gboolean
+is_loaded (GtkWidget *group)
+{
+  return gtk_widget_get_child_visible (group) && gtk_widget_get_mapped (group);
+}
+
+
+static void
+test_hdy_preferences_page_lazy (void)
+{
+  g_autoptr (GList) children = NULL;
+  HdyPreferencesPage *page;
+  GtkWidget *window, *groups[N_LAZY_GROUPS], *focus_row = NULL;
+  GtkAdjustment *vadjustment;
+  gint i, j;
+
+  page = HDY_PREFERENCES_PAGE (hdy_preferences_page_new ());
+  g_assert_nonnull (page);
+
+  g_assert_false (hdy_preferences_page_get_lazy (page));
+
+  hdy_preferences_page_set_lazy (page, TRUE);
+  g_assert_true (hdy_preferences_page_get_lazy (page));
+
+  for (i = 0; i < N_LAZY_GROUPS; i++) {
+    groups[i] = hdy_preferences_group_new ();
+
+    for (j = 0; j < N_LAZY_ROWS; j++) {
+      GtkWidget *row = hdy_action_row_new ();
+
+      hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Row");
+      gtk_container_add (GTK_CONTAINER (groups[i]), row);
+
+      if (i == N_LAZY_GROUPS / 2 && j == 0)
+        focus_row = row;
+    }
+
+    gtk_container_add (GTK_CONTAINER (page), groups[i]);
+  }
+
+  /* Unloaded groups are still children of the page. */
+  children = gtk_container_get_children (GTK_CONTAINER (page));
+  g_assert_cmpint (g_list_length (children), ==, N_LAZY_GROUPS);
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_default_size (GTK_WINDOW (window), 400, 300);
+  gtk_container_add (GTK_CONTAINER (window), GTK_WIDGET (page));
+  gtk_widget_show_all (window);
+  run_layout (window);
+
+  /* Only the groups near the top are loaded. */
+  g_assert_true (is_loaded (groups[0]));
+  g_assert_false (is_loaded (groups[N_LAZY_GROUPS / 2]));
+  g_assert_false (is_loaded (groups[N_LAZY_GROUPS - 1]));
+
+  /* Scrolling to the end loads the last groups. */
+  vadjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (gtk_widget_get_ancestor (groups[0], GTK_TYPE_SCROLLED_WINDOW)));
+  gtk_adjustment_set_value (vadjustment,
+                            gtk_adjustment_get_upper (vadjustment) -
+                            gtk_adjustment_get_page_size (vadjustment));
+  run_layout (window);
+
+  g_assert_true (is_loaded (groups[N_LAZY_GROUPS - 1]));
+  g_assert_false (is_loaded (groups[N_LAZY_GROUPS / 2]));
+
+  /* Focusing a row loads its group. */
+  gtk_widget_grab_focus (focus_row);
+  run_layout (window);
+
+  g_assert_true (is_loaded (groups[N_LAZY_GROUPS / 2]));
+
+  /* Loaded groups stay loaded, and disabling laziness loads all of them. */
+  hdy_preferences_page_set_lazy (page, FALSE);
+  g_assert_false (hdy_preferences_page_get_lazy (page));
+  run_layout (window);
+
+  for (i = 0; i < N_LAZY_GROUPS; i++)
+    g_assert_true (is_loaded (groups[i]));
+
+  gtk_widget_destroy (window);
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -76,6 +178,7 @@ main (gint argc,
   g_test_add_func("/Handy/PreferencesPage/add", test_hdy_preferences_page_add);
   g_test_add_func("/Handy/PreferencesPage/title", test_hdy_preferences_page_title);
   g_test_add_func("/Handy/PreferencesPage/icon_name", test_hdy_preferences_page_icon_name);
+  g_test_add_func("/Handy/PreferencesPage/lazy", test_hdy_preferences_page_lazy);
 
   return g_test_run();
 }
@@ -7,6 +7,8 @@
 #define HANDY_USE_UNSTABLE_API
 #include <handy.h>
 
+#include "test-utils.h"
+
 
 static void
 test_hdy_preferences_window_add (void)
@@ -30,6 +32,160 @@ test_hdy_preferences_window_add (void)
 }
 
 
+static void
+test_hdy_preferences_window_search (void)
+{
+  g_autoptr (HdyPreferencesWindow) window = NULL;
+  gboolean fuzzy_search;
+  guint max_search_results;
+
+  window = g_object_ref_sink (HDY_PREFERENCES_WINDOW (hdy_preferences_window_new ()));
+  g_assert_nonnull (window);
+
+  g_assert_false (hdy_preferences_window_get_fuzzy_search (window));
+  g_assert_cmpuint (hdy_preferences_window_get_max_search_results (window), ==, 0);
+
+  hdy_preferences_window_set_fuzzy_search (window, TRUE);
+  g_assert_true (hdy_preferences_window_get_fuzzy_search (window));
+
+  hdy_preferences_window_set_max_search_results (window, 10);
+  g_assert_cmpuint (hdy_preferences_window_get_max_search_results (window), ==, 10);
+
+  g_object_set (window, "fuzzy-search", FALSE, "max-search-results", 0, NULL);
+  g_object_get (window,
+                "fuzzy-search", &fuzzy_search,
+                "max-search-results", &max_search_results,
+                NULL);
+  g_assert_false (fuzzy_search);
+  g_assert_cmpuint (max_search_results, ==, 0);
+}
+
+
+/* Returns: the last added row */
+static GtkWidget *
+add_rows (HdyPreferencesWindow *window,
+          const gchar          *page_title,
+          const gchar          *group_title,
+          const gchar * const  *titles)
+{
+  GtkWidget *page = hdy_preferences_page_new ();
+  GtkWidget *group = hdy_preferences_group_new ();
+  GtkWidget *row = NULL;
+
+  hdy_preferences_page_set_title (HDY_PREFERENCES_PAGE (page), page_title);
+  hdy_preferences_group_set_title (HDY_PREFERENCES_GROUP (group), group_title);
+
+  for (; *titles; titles++) {
+    row = hdy_action_row_new ();
+    hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), *titles);
+    gtk_widget_show (row);
+    gtk_container_add (GTK_CONTAINER (group), row);
+  }
+
+  gtk_widget_show (group);
+  gtk_container_add (GTK_CONTAINER (page), group);
+  gtk_widget_show (page);
+  gtk_container_add (GTK_CONTAINER (window), page);
+
+  return row;
+}
+
+
+/* Returns the titles of the displayed results, in their displayed order. */
+static gchar *
+search (GtkWidget   *entry,
+        GtkWidget   *results,
+        const gchar *query)
+{
+  g_autoptr (GList) children = NULL;
+  g_autoptr (GPtrArray) titles = g_ptr_array_new ();
+  GList *l;
+
+  gtk_entry_set_text (GTK_ENTRY (entry), query);
+  /* Don't wait for the search entry's delay. */
+  g_signal_emit_by_name (entry, "search-changed");
+
+  children = gtk_container_get_children (GTK_CONTAINER (results));
+  for (l = children; l; l = l->next)
+    if (gtk_widget_get_visible (l->data))
+      g_ptr_array_add (titles, (gpointer) hdy_preferences_row_get_title (l->data));
+  g_ptr_array_add (titles, NULL);
+
+  return g_strjoinv (", ", (gchar **) titles->pdata);
+}
+
+
+static void
+assert_search (GtkWidget   *entry,
+               GtkWidget   *results,
+               const gchar *query,
+               const gchar *expected)
+{
+  g_autofree gchar *found = search (entry, results, query);
+
+  g_assert_cmpstr (found, ==, expected);
+}
+
+
+static void
+test_hdy_preferences_window_search_results (void)
+{
+  const gchar * const general_rows[] = { "Network", "Wired net", "Internet", "Notebook entries", "Sound", NULL };
+  const gchar * const device_rows[] = { "Adapter", NULL };
+  g_autoptr (HdyPreferencesWindow) window = NULL;
+  GtkWidget *entry, *results, *row;
+
+  window = g_object_ref_sink (HDY_PREFERENCES_WINDOW (hdy_preferences_window_new ()));
+  g_assert_nonnull (window);
+
+  row = add_rows (window, "General", "Misc", general_rows);
+  add_rows (window, "Devices", "Network cards", device_rows);
+
+  entry = test_find_internal_child (GTK_WIDGET (window), "search_entry");
+  results = test_find_internal_child (GTK_WIDGET (window), "search_results");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (test_find_internal_child (GTK_WIDGET (window), "search_button")), TRUE);
+
+  /* Without fuzzy search, titles and subtitles containing the query match, in
+   * the order of the preferences.
+   */
+  assert_search (entry, results, "net", "Network, Wired net, Internet, Adapter");
+  assert_search (entry, results, "NET", "Network, Wired net, Internet, Adapter");
+
+  /* Narrowing the query only keeps the previous results still matching. */
+  assert_search (entry, results, "netw", "Network, Adapter");
+
+  /* Widening it matches against the whole index again. */
+  assert_search (entry, results, "ne", "Network, Wired net, Internet, Notebook entries, Sound, Adapter");
+  assert_search (entry, results, "xyz", "");
+
+  /* A retitled row is matched again on its own, in its place. */
+  assert_search (entry, results, "net", "Network, Wired net, Internet, Adapter");
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Subnet");
+  assert_search (entry, results, "net", "Network, Wired net, Internet, Subnet, Adapter");
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Sound");
+  assert_search (entry, results, "net", "Network, Wired net, Internet, Adapter");
+
+  /* With fuzzy search, title prefixes rank above title word starts, subtitle
+   * word starts, title substrings and title subsequences.
+   */
+  hdy_preferences_window_set_fuzzy_search (window, TRUE);
+  assert_search (entry, results, "net", "Network, Wired net, Adapter, Internet, Notebook entries");
+
+  /* Only the best results are displayed when they are capped. */
+  hdy_preferences_window_set_max_search_results (window, 2);
+  assert_search (entry, results, "net", "Network, Wired net");
+
+  /* A retitled row is ranked among the other results, and the cap is kept. */
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Netbook");
+  assert_search (entry, results, "net", "Network, Netbook");
+  hdy_preferences_row_set_title (HDY_PREFERENCES_ROW (row), "Sound");
+  assert_search (entry, results, "net", "Network, Wired net");
+
+  hdy_preferences_window_set_max_search_results (window, 0);
+  assert_search (entry, results, "net", "Network, Wired net, Adapter, Internet, Notebook entries");
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -38,6 +194,8 @@ main (gint argc,
   hdy_init ();
 
   g_test_add_func("/Handy/PreferencesWindow/add", test_hdy_preferences_window_add);
+  g_test_add_func("/Handy/PreferencesWindow/search", test_hdy_preferences_window_search);
+  g_test_add_func("/Handy/PreferencesWindow/search_results", test_hdy_preferences_window_search_results);
 
   return g_test_run();
 }
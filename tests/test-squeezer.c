@@ -143,6 +143,130 @@ test_hdy_squeezer_child_enabled (void)
 }
 
 
+static GtkWidget *
+add_sized_child (HdySqueezer *squeezer,
+                 gint         width)
+{
+  GtkWidget *child = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+
+  gtk_widget_set_size_request (child, width, 20);
+  gtk_widget_show (child);
+  gtk_container_add (GTK_CONTAINER (squeezer), child);
+
+  return child;
+}
+
+
+static void
+allocate_squeezer (HdySqueezer *squeezer,
+                   gint         width)
+{
+  GtkAllocation allocation = { 0, 0, width, 20 };
+
+  gtk_widget_get_preferred_size (GTK_WIDGET (squeezer), NULL, NULL);
+  gtk_widget_size_allocate (GTK_WIDGET (squeezer), &allocation);
+}
+
+
+static void
+test_hdy_squeezer_switch_threshold (void)
+{
+  g_autoptr (HdySqueezer) squeezer = NULL;
+  GtkWidget *large, *small;
+
+  squeezer = g_object_ref_sink (HDY_SQUEEZER (hdy_squeezer_new ()));
+  g_assert_nonnull (squeezer);
+
+  g_assert_cmpuint (hdy_squeezer_get_switch_threshold (squeezer), ==, 0);
+
+  hdy_squeezer_set_switch_threshold (squeezer, 24);
+  g_assert_cmpuint (hdy_squeezer_get_switch_threshold (squeezer), ==, 24);
+
+  hdy_squeezer_set_switch_threshold (squeezer, 0);
+  g_assert_cmpuint (hdy_squeezer_get_switch_threshold (squeezer), ==, 0);
+
+  large = add_sized_child (squeezer, 200);
+  small = add_sized_child (squeezer, 100);
+  gtk_widget_show (GTK_WIDGET (squeezer));
+  hdy_squeezer_set_switch_threshold (squeezer, 20);
+
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+
+  /* Switching to a smaller child doesn't need any extra room. */
+  allocate_squeezer (squeezer, 199);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  /* Switching back needs the threshold on top of the child's size. */
+  allocate_squeezer (squeezer, 200);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  allocate_squeezer (squeezer, 219);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  allocate_squeezer (squeezer, 220);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+}
+
+
+static void
+test_hdy_squeezer_switch_delay (void)
+{
+  g_autoptr (HdySqueezer) squeezer = NULL;
+  GtkWidget *large, *small;
+
+  squeezer = g_object_ref_sink (HDY_SQUEEZER (hdy_squeezer_new ()));
+  g_assert_nonnull (squeezer);
+
+  g_assert_cmpuint (hdy_squeezer_get_switch_delay (squeezer), ==, 0);
+
+  hdy_squeezer_set_switch_delay (squeezer, 300);
+  g_assert_cmpuint (hdy_squeezer_get_switch_delay (squeezer), ==, 300);
+
+  hdy_squeezer_set_switch_delay (squeezer, 0);
+  g_assert_cmpuint (hdy_squeezer_get_switch_delay (squeezer), ==, 0);
+
+  large = add_sized_child (squeezer, 200);
+  small = add_sized_child (squeezer, 100);
+  gtk_widget_show (GTK_WIDGET (squeezer));
+  hdy_squeezer_set_switch_delay (squeezer, 60000);
+
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+
+  /* Switching to a smaller child is never delayed. */
+  allocate_squeezer (squeezer, 150);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  /* Switching back is delayed as the small child was just shown. */
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  /* A disabled visible child isn't kept during the delay. */
+  hdy_squeezer_set_child_enabled (squeezer, small, FALSE);
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+
+  hdy_squeezer_set_child_enabled (squeezer, small, TRUE);
+  allocate_squeezer (squeezer, 150);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  /* Neither is a hidden one. */
+  gtk_widget_hide (small);
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+
+  gtk_widget_show (small);
+  allocate_squeezer (squeezer, 150);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == small);
+
+  /* Without a delay, the switch happens right away. */
+  hdy_squeezer_set_switch_delay (squeezer, 0);
+  allocate_squeezer (squeezer, 300);
+  g_assert (hdy_squeezer_get_visible_child (squeezer) == large);
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -157,6 +281,8 @@ main (gint argc,
   g_test_add_func("/Handy/ViewSwitcher/show_hide_child", test_hdy_squeezer_show_hide_child);
   g_test_add_func("/Handy/ViewSwitcher/interpolate_size", test_hdy_squeezer_interpolate_size);
   g_test_add_func("/Handy/ViewSwitcher/child_enabled", test_hdy_squeezer_child_enabled);
+  g_test_add_func("/Handy/ViewSwitcher/switch_threshold", test_hdy_squeezer_switch_threshold);
+  g_test_add_func("/Handy/ViewSwitcher/switch_delay", test_hdy_squeezer_switch_delay);
 
   return g_test_run();
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "test-utils.h"
+
+typedef struct {
+  const gchar *name;
+  GtkWidget *found;
+} FindData;
+
+static void
+find_internal_child_cb (GtkWidget *widget,
+                        FindData  *data)
+{
+  if (data->found)
+    return;
+
+  if (g_strcmp0 (gtk_buildable_get_name (GTK_BUILDABLE (widget)), data->name) == 0) {
+    data->found = widget;
+
+    return;
+  }
+
+  if (GTK_IS_CONTAINER (widget))
+    gtk_container_forall (GTK_CONTAINER (widget), (GtkCallback) find_internal_child_cb, data);
+}
+
+/**
+ * test_find_internal_child:
+ * @widget: a #GtkWidget
+ * @name: the id of the child in the template of @widget
+ *
+ * Looks up an internal child of a widget built from a template by its id.
+ * Popovers are attached to the toplevel rather than to the widget they are
+ * relative to, so the whole toplevel of @widget is searched.
+ *
+ * Returns: (transfer none): the internal child, it must exist
+ */
+GtkWidget *
+test_find_internal_child (GtkWidget   *widget,
+                          const gchar *name)
+{
+  FindData data = { name, NULL };
+
+  gtk_container_forall (GTK_CONTAINER (gtk_widget_get_toplevel (widget)),
+                        (GtkCallback) find_internal_child_cb, &data);
+  g_assert_nonnull (data.found);
+
+  return data.found;
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2020 Purism SPC
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+GtkWidget *test_find_internal_child (GtkWidget   *widget,
+                                     const gchar *name);
+
+G_END_DECLS
@@ -7,6 +7,15 @@
 #define HANDY_USE_UNSTABLE_API
 #include <handy.h>
 
+gint notified;
+
+
+static void
+notify_cb (GtkWidget *widget, gpointer data)
+{
+  notified++;
+}
+
 
 static void
 test_hdy_view_switcher_policy (void)
@@ -69,6 +78,78 @@ test_hdy_view_switcher_stack (void)
 }
 
 
+static void
+add_page (GListStore  *store,
+          const gchar *title)
+{
+  g_autoptr (GtkWidget) page = g_object_ref_sink (hdy_preferences_page_new ());
+
+  hdy_preferences_page_set_title (HDY_PREFERENCES_PAGE (page), title);
+  g_list_store_append (store, page);
+}
+
+
+static void
+test_hdy_view_switcher_model (void)
+{
+  g_autoptr (HdyViewSwitcher) view_switcher = NULL;
+  g_autoptr (GListStore) store = NULL;
+  g_autoptr (GtkStack) stack = NULL;
+
+  view_switcher = g_object_ref_sink (HDY_VIEW_SWITCHER (hdy_view_switcher_new ()));
+  g_assert_nonnull (view_switcher);
+
+  store = g_list_store_new (HDY_TYPE_PREFERENCES_PAGE);
+  add_page (store, "First");
+  add_page (store, "Second");
+  add_page (store, "Third");
+
+  g_assert_null (hdy_view_switcher_get_model (view_switcher));
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, -1);
+
+  hdy_view_switcher_bind_model (view_switcher, G_LIST_MODEL (store));
+  g_assert (hdy_view_switcher_get_model (view_switcher) == G_LIST_MODEL (store));
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 0);
+
+  hdy_view_switcher_set_selected_index (view_switcher, 2);
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 2);
+
+  g_list_store_remove (store, 0);
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 1);
+
+  g_list_store_remove (store, 1);
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 0);
+
+  /* Removing the selected page notifies even if the index stays the same. */
+  add_page (store, "Fourth");
+  notified = 0;
+  g_signal_connect (view_switcher, "notify::selected-index", G_CALLBACK (notify_cb), NULL);
+  g_list_store_remove (store, 0);
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 0);
+  g_assert_cmpint (notified, ==, 1);
+
+  /* Removing another page doesn't. */
+  add_page (store, "Fifth");
+  g_list_store_remove (store, 1);
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, 0);
+  g_assert_cmpint (notified, ==, 1);
+
+  g_signal_handlers_disconnect_by_func (view_switcher, notify_cb, NULL);
+
+  stack = g_object_ref_sink (GTK_STACK (gtk_stack_new ()));
+  hdy_view_switcher_set_stack (view_switcher, stack);
+  g_assert_null (hdy_view_switcher_get_model (view_switcher));
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, -1);
+
+  hdy_view_switcher_bind_model (view_switcher, G_LIST_MODEL (store));
+  g_assert_null (hdy_view_switcher_get_stack (view_switcher));
+
+  hdy_view_switcher_bind_model (view_switcher, NULL);
+  g_assert_null (hdy_view_switcher_get_model (view_switcher));
+  g_assert_cmpint (hdy_view_switcher_get_selected_index (view_switcher), ==, -1);
+}
+
+
 gint
 main (gint argc,
       gchar *argv[])
@@ -79,6 +160,7 @@ main (gint argc,
   g_test_add_func("/Handy/ViewSwitcher/policy", test_hdy_view_switcher_policy);
   g_test_add_func("/Handy/ViewSwitcher/narrow_ellipsize", test_hdy_view_switcher_narrow_ellipsize);
   g_test_add_func("/Handy/ViewSwitcher/stack", test_hdy_view_switcher_stack);
+  g_test_add_func("/Handy/ViewSwitcher/model", test_hdy_view_switcher_model);
 
   return g_test_run();
 }